@@ -0,0 +1,230 @@
+#include <new>
+#include <string>
+#include <vector>
+
+#include "ffm_api.h"
+#include "ffm_io.h"
+#include "ffm_numerics.h"
+#include "location.h"
+#include "results.h"
+#include "site_inputs.h"
+#include "species.h"
+
+/*
+  The handles are thin wrappers around the objects used by the executable, so that a
+  site computed here gives the same results as the equivalent input file. Nothing is
+  shared between handles.
+*/
+
+struct ffm_site {
+  SiteInputs inputs;
+};
+
+struct ffm_results {
+  Results results;
+};
+
+namespace {
+
+  bool knownLevel(const ffm_level& level) {
+    return level == FFM_NEAR_SURFACE || level == FFM_ELEVATED ||
+      level == FFM_MID_STOREY || level == FFM_CANOPY;
+  }
+
+}
+
+/*!\brief The version of the interface the library was built with
+  \return FFM_API_VERSION
+*/
+int ffm_api_version(void) {return FFM_API_VERSION;}
+
+/*!\brief A description of a status code
+  \param status
+  \return A static string, which must not be freed
+*/
+const char* ffm_status_string(ffm_status status) {
+  switch (status) {
+  case FFM_OK: return "ok";
+  case FFM_INVALID_ARGUMENT: return "invalid argument";
+  case FFM_INVALID_INPUTS: return "invalid inputs";
+  case FFM_ERROR: return "model error";
+  }
+  return "unknown status";
+}
+
+/*!\brief Creates a site with no strata
+  \param params
+  \return A new site, to be released with ffm_site_destroy, or null if params is null
+  or memory is exhausted
+*/
+ffm_site* ffm_site_create(const ffm_site_params* params) {
+  if (!params) return nullptr;
+  ffm_site* site = new (std::nothrow) ffm_site;
+  if (!site) return nullptr;
+
+  SiteInputs& in = site->inputs;
+  in.slope = params->slope_deg*PI/180.0;
+  in.deadFuelMoistCont = params->dead_fuel_moisture_content;
+  in.fuelLoad = params->fuel_load_t_ha*0.1;
+  in.meanFuelDiameter = params->mean_fuel_diameter_m;
+  in.meanFinenessLeaves = params->mean_fineness_leaves_m;
+  in.airTemp = params->air_temperature_c;
+  in.incidentWindSpeed = params->incident_wind_speed_kmh/3.6;
+  in.firelineLength = params->fireline_length_m;
+  return site;
+}
+
+/*!\brief Releases a site, which may be null*/
+void ffm_site_destroy(ffm_site* site) {delete site;}
+
+/*!\brief Adds a stratum to a site
+  \param site
+  \param level Each level may be added once
+  \param plant_separation_m
+  \param species Copied, so need not outlive the call
+  \param num_species At least one
+  \return FFM_OK, or FFM_INVALID_ARGUMENT if the level is unknown or already present
+  or there are no species
+*/
+ffm_status ffm_site_add_stratum(ffm_site* site, ffm_level level, double plant_separation_m,
+				const ffm_species_params* species, size_t num_species) {
+  if (!site || !knownLevel(level) || !species || num_species == 0) return FFM_INVALID_ARGUMENT;
+  for (const SiteInputs::StratumInputs& st : site->inputs.strata)
+    if (st.level == static_cast<Stratum::LevelType>(level)) return FFM_INVALID_ARGUMENT;
+  for (size_t i = 0; i < num_species; ++i)
+    if (species[i].leaf_form != FFM_ROUND_LEAF && species[i].leaf_form != FFM_FLAT_LEAF)
+      return FFM_INVALID_ARGUMENT;
+
+  try {
+    SiteInputs::StratumInputs st;
+    st.level = static_cast<Stratum::LevelType>(level);
+    st.plantSep = plant_separation_m;
+    st.species.resize(num_species);
+    for (size_t i = 0; i < num_species; ++i) {
+      const ffm_species_params& p = species[i];
+      SiteInputs::SpeciesInputs& sp = st.species[i];
+      sp.name = p.name ? p.name : "";
+      sp.composition = p.composition;
+      sp.hc = p.hc;
+      sp.he = p.he;
+      sp.ht = p.ht;
+      sp.hp = p.hp;
+      sp.w = p.w;
+      sp.liveLeafMoisture = p.live_leaf_moisture;
+      sp.propDead = p.proportion_dead;
+      sp.silFreeAshCont = p.silica_free_ash_content;
+      sp.ignitTemp = p.ignition_temperature;
+      sp.leafForm = static_cast<Species::LeafFormType>(p.leaf_form);
+      sp.leafThick = p.leaf_thickness;
+      sp.leafWidth = p.leaf_width;
+      sp.leafLength = p.leaf_length;
+      sp.leafSep = p.leaf_separation;
+      sp.stemOrder = p.stem_order;
+      sp.clumpDiam = p.clump_diameter;
+      sp.clumpSep = p.clump_separation;
+    }
+    site->inputs.strata.push_back(st);
+  }
+  catch (...) {
+    return FFM_ERROR;
+  }
+  return FFM_OK;
+}
+
+/*!\brief Sets how two strata overlap, as the "overlapping" input
+  \param site
+  \param level1
+  \param level2
+  \param overlap
+  \return FFM_OK, or FFM_INVALID_ARGUMENT if a level or the overlap type is unknown
+*/
+ffm_status ffm_site_add_overlap(ffm_site* site, ffm_level level1, ffm_level level2,
+				ffm_overlap overlap) {
+  if (!site || !knownLevel(level1) || !knownLevel(level2) ||
+      (overlap != FFM_AUTO_OVERLAP && overlap != FFM_NOT_OVERLAPPED && overlap != FFM_OVERLAPPED))
+    return FFM_INVALID_ARGUMENT;
+  try {
+    site->inputs.strataOverlaps.push_back(std::make_tuple(static_cast<Stratum::LevelType>(level1),
+							  static_cast<Stratum::LevelType>(level2),
+							  static_cast<Forest::StrataOverlapType>(overlap)));
+  }
+  catch (...) {
+    return FFM_ERROR;
+  }
+  return FFM_OK;
+}
+
+/*!\brief Runs the model for a site
+  \param site Not modified, so may be computed on several threads at once
+  \param results Set to new results, to be released with ffm_results_destroy, on success
+  \return FFM_OK, FFM_INVALID_INPUTS if the input file parser would have rejected the
+  site, or FFM_ERROR if the model failed
+*/
+ffm_status ffm_compute(const ffm_site* site, ffm_results** results) {
+  if (!site || !results) return FFM_INVALID_ARGUMENT;
+  *results = nullptr;
+  try {
+    if (!checkSiteInputs(site->inputs)) return FFM_INVALID_INPUTS;
+    *results = new ffm_results{buildLocation(site->inputs).results(Results::DETAILED)};
+  }
+  catch (...) {
+    return FFM_ERROR;
+  }
+  return FFM_OK;
+}
+
+/*!\brief Releases results, which may be null*/
+void ffm_results_destroy(ffm_results* results) {delete results;}
+
+/*!\brief Reads the overall outputs
+  \param results
+  \param outputs Filled with the outputs
+  \return FFM_OK, or FFM_INVALID_ARGUMENT if either pointer is null
+*/
+ffm_status ffm_results_outputs(const ffm_results* results, ffm_outputs* outputs) {
+  if (!results || !outputs) return FFM_INVALID_ARGUMENT;
+  const Results& res = results->results;
+  outputs->ros_kmh = res.ros()*3.6;
+  outputs->flame_length_m = res.flameLength();
+  outputs->flame_angle_deg = res.flameAngle()*180/PI;
+  outputs->flame_tip_height_m = res.flameTipHeight();
+  outputs->flame_origin_height_m = res.flameOriginHeight();
+  outputs->flame_depth_m = res.flameDepth();
+  outputs->surface_ros_kmh = res.surfaceROS()*3.6;
+  outputs->surface_flame_length_m = res.surfaceFlameLength();
+  outputs->surface_flame_height_m = res.surfaceFlameHeight();
+  outputs->surface_flame_angle_deg = res.surfaceFlameAngle()*180/PI;
+  outputs->crown_fire_type = static_cast<ffm_crown_fire_type>(res.crownFireType());
+  outputs->crown_run_length_m = res.crownRunLength();
+  outputs->crown_run_velocity_kmh = res.crownRunVelocity()*3.6;
+  outputs->wind_reduction_factor = res.windReductionFactor();
+  outputs->scorch_height_mcarthur_m = res.scorchHeightMcarthur();
+  outputs->scorch_height_luke_mcarthur_m = res.scorchHeightLukeMcarthur();
+  outputs->scorch_height_van_wagner_m = res.scorchHeightVanWagner();
+  outputs->scorch_height_van_wagner_with_wind_m = res.scorchHeightVanWagnerWithWind();
+  return FFM_OK;
+}
+
+/*!\brief The number of strata with outputs, zero if results is null*/
+size_t ffm_results_num_strata(const ffm_results* results) {
+  return results ? results->results.strataResults().size() : 0;
+}
+
+/*!\brief Reads the outputs of a stratum
+  \param results
+  \param i Index of the stratum, less than ffm_results_num_strata
+  \param outputs Filled with the outputs
+  \return FFM_OK, or FFM_INVALID_ARGUMENT if a pointer is null or i is out of range
+*/
+ffm_status ffm_results_stratum(const ffm_results* results, size_t i, ffm_stratum_outputs* outputs) {
+  if (!results || !outputs || i >= results->results.strataResults().size()) return FFM_INVALID_ARGUMENT;
+  const StratumResults& sr = results->results.strataResults()[i];
+  outputs->level = static_cast<ffm_level>(sr.level());
+  outputs->ros_kmh = sr.ros()*3.6;
+  outputs->flame_length_m = sr.flameLength();
+  outputs->flame_angle_deg = sr.flameAngle()*180/PI;
+  outputs->flame_tip_height_m = sr.flameTipHeight();
+  outputs->flame_origin_height_m = sr.flameOriginHeight();
+  outputs->proportion_burnt = sr.proportionBurnt();
+  return FFM_OK;
+}
@@ -0,0 +1,160 @@
+#ifndef FFM_API_H
+#define FFM_API_H
+
+/*!\file ffm_api.h
+  \brief C interface to the forest flammability model, as built into libffm.
+
+  A site is described by an ffm_site, to which strata, each with its species, and
+  strata overlaps are added. ffm_compute builds the site and runs the model, giving
+  an ffm_results object from which the outputs are read. Inputs are in the units of
+  the input file (slope in degrees, wind speed in km/h, fuel load in tonnes per hectare)
+  and outputs are in the units of the structured output (see result_emitter.cc), so
+  that rates of spread are in km/h and angles in degrees.
+
+  Every function is reentrant. The only global mutable state in the library is the
+  record of trace spans (util/ffm_trace.h) and allocation phases (util/ffm_alloc.h),
+  which is guarded by locks and written only while tracing is enabled, which no
+  function here does, or in an allocation tracking build. So any number of threads
+  may call the library at once provided that no ffm_site is modified while another
+  thread uses it. A single ffm_site may be computed on several threads
+  at once, and ffm_results objects are read only.
+
+  Functions that can fail return an ffm_status. No function exits the process or
+  lets an exception escape.
+*/
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!\brief Incremented whenever a structure or function signature below changes*/
+#define FFM_API_VERSION 1
+
+typedef enum {
+  FFM_OK = 0,
+  FFM_INVALID_ARGUMENT = 1,  /*!< a null pointer or an unknown level or type */
+  FFM_INVALID_INPUTS = 2,    /*!< inputs that the input file parser would reject */
+  FFM_ERROR = 3              /*!< the model failed */
+} ffm_status;
+
+/*!\brief Stratum levels, as Stratum::LevelType*/
+typedef enum {
+  FFM_NEAR_SURFACE = 1,
+  FFM_ELEVATED = 2,
+  FFM_MID_STOREY = 3,
+  FFM_CANOPY = 4
+} ffm_level;
+
+/*!\brief Strata overlap types, as Forest::StrataOverlapType*/
+typedef enum {
+  FFM_AUTO_OVERLAP = -1,
+  FFM_NOT_OVERLAPPED = 0,
+  FFM_OVERLAPPED = 1
+} ffm_overlap;
+
+/*!\brief Leaf forms, as Species::LeafFormType*/
+typedef enum {
+  FFM_ROUND_LEAF = 0,
+  FFM_FLAT_LEAF = 1
+} ffm_leaf_form;
+
+/*!\brief Crown fire types, as Results::CrownFireType*/
+typedef enum {
+  FFM_UNCLASSIFIED = 0,
+  FFM_PASSIVE = 1,
+  FFM_ACTIVE = 2
+} ffm_crown_fire_type;
+
+/*!\brief Surface, weather and other site inputs, with the names of the input file*/
+typedef struct {
+  double slope_deg;
+  double dead_fuel_moisture_content;
+  double fuel_load_t_ha;
+  double mean_fuel_diameter_m;
+  double mean_fineness_leaves_m;
+  double air_temperature_c;
+  double incident_wind_speed_kmh;
+  double fireline_length_m;
+} ffm_site_params;
+
+/*!\brief Species inputs, with the names of the input file*/
+typedef struct {
+  const char* name;                /*!< copied, may be null */
+  double composition;
+  double hc, he, ht, hp, w;
+  double live_leaf_moisture;
+  double proportion_dead;
+  double silica_free_ash_content;
+  double ignition_temperature;
+  ffm_leaf_form leaf_form;
+  double leaf_thickness, leaf_width, leaf_length, leaf_separation;
+  double stem_order, clump_diameter, clump_separation;
+} ffm_species_params;
+
+/*!\brief Overall outputs, see Results*/
+typedef struct {
+  double ros_kmh;
+  double flame_length_m;
+  double flame_angle_deg;
+  double flame_tip_height_m;
+  double flame_origin_height_m;
+  double flame_depth_m;
+  double surface_ros_kmh;
+  double surface_flame_length_m;
+  double surface_flame_height_m;
+  double surface_flame_angle_deg;
+  ffm_crown_fire_type crown_fire_type;
+  double crown_run_length_m;
+  double crown_run_velocity_kmh;
+  double wind_reduction_factor;
+  double scorch_height_mcarthur_m;
+  double scorch_height_luke_mcarthur_m;
+  double scorch_height_van_wagner_m;
+  double scorch_height_van_wagner_with_wind_m;
+} ffm_outputs;
+
+/*!\brief Outputs for a single stratum, see StratumResults*/
+typedef struct {
+  ffm_level level;
+  double ros_kmh;
+  double flame_length_m;
+  double flame_angle_deg;
+  double flame_tip_height_m;
+  double flame_origin_height_m;
+  double proportion_burnt;
+} ffm_stratum_outputs;
+
+typedef struct ffm_site ffm_site;
+typedef struct ffm_results ffm_results;
+
+int ffm_api_version(void);
+
+const char* ffm_status_string(ffm_status status);
+
+ffm_site* ffm_site_create(const ffm_site_params* params);
+
+void ffm_site_destroy(ffm_site* site);
+
+ffm_status ffm_site_add_stratum(ffm_site* site, ffm_level level, double plant_separation_m,
+				const ffm_species_params* species, size_t num_species);
+
+ffm_status ffm_site_add_overlap(ffm_site* site, ffm_level level1, ffm_level level2,
+				ffm_overlap overlap);
+
+ffm_status ffm_compute(const ffm_site* site, ffm_results** results);
+
+void ffm_results_destroy(ffm_results* results);
+
+ffm_status ffm_results_outputs(const ffm_results* results, ffm_outputs* outputs);
+
+size_t ffm_results_num_strata(const ffm_results* results);
+
+ffm_status ffm_results_stratum(const ffm_results* results, size_t i, ffm_stratum_outputs* outputs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FFM_API_H */
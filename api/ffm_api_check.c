@@ -0,0 +1,117 @@
+/*
+  Check of the promises made in ffm_api.h, built and run with 'make api-check'.
+
+  The site of data/94s.txt is computed once, then again and again on several threads
+  at once from the same ffm_site, and every result must be identical bit for bit to the
+  first. Invalid arguments and inputs must give an ffm_status, not end the process. The
+  overall outputs are printed for comparison with 'ffm data/94s.txt'. For a race check
+  'make clean' then 'make api-check SANITIZE=-fsanitize=thread'.
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ffm_api.h"
+
+#define NUM_THREADS 8
+#define NUM_RUNS 20
+
+static ffm_site* site;
+static ffm_outputs expected;
+static int failures[NUM_THREADS];
+
+static ffm_species_params dicot(double clumpDiam, double he, double ht, double hc, double hp,
+				double w) {
+  ffm_species_params sp;
+  memset(&sp, 0, sizeof(sp));
+  sp.name = "Dicot";
+  sp.composition = 100;
+  sp.hc = hc;
+  sp.he = he;
+  sp.ht = ht;
+  sp.hp = hp;
+  sp.w = w;
+  sp.live_leaf_moisture = 1.0;
+  sp.proportion_dead = 0;
+  sp.silica_free_ash_content = -99;
+  sp.ignition_temperature = 220;
+  sp.leaf_form = FFM_FLAT_LEAF;
+  sp.leaf_thickness = 0.3e-3;
+  sp.leaf_width = 12e-3;
+  sp.leaf_length = 54e-3;
+  sp.leaf_separation = 1e-2;
+  sp.stem_order = 4;
+  sp.clump_diameter = clumpDiam;
+  sp.clump_separation = 0;
+  return sp;
+}
+
+/* computes the shared site repeatedly, counting results that differ from the first */
+static void* work(void* arg) {
+  int t = *(const int*)arg;
+  for (int i = 0; i < NUM_RUNS; i++) {
+    ffm_results* res = NULL;
+    ffm_outputs out;
+    memset(&out, 0, sizeof(out));
+    if (ffm_compute(site, &res) != FFM_OK || ffm_results_outputs(res, &out) != FFM_OK ||
+	memcmp(&out, &expected, sizeof(out)) != 0)
+      failures[t]++;
+    ffm_results_destroy(res);
+  }
+  return NULL;
+}
+
+static int check(int okay, const char* what) {
+  if (!okay) printf("FAILED: %s\n", what);
+  return okay ? 0 : 1;
+}
+
+int main(void) {
+  int failed = 0;
+
+  ffm_site_params params = {-5, 0.036, 18, 5e-3, 0.4e-3, 34.8, 26, 100};
+  site = ffm_site_create(&params);
+  ffm_species_params elevated = dicot(1.2, 1.3, 1.8, 0.6, 2, 1.2);
+  ffm_species_params canopy[2];
+  canopy[0] = canopy[1] = dicot(3.2, 2.3, 8.6, 1.3, 10, 3.2);
+  failed += check(ffm_site_add_stratum(site, FFM_ELEVATED, 3.9, &elevated, 1) == FFM_OK,
+		  "add elevated stratum");
+  failed += check(ffm_site_add_stratum(site, FFM_CANOPY, 5.3, canopy, 2) == FFM_OK,
+		  "add canopy stratum");
+
+  ffm_results* res = NULL;
+  memset(&expected, 0, sizeof(expected));
+  failed += check(ffm_compute(site, &res) == FFM_OK && ffm_results_outputs(res, &expected) == FFM_OK,
+		  "compute site");
+  printf("ros %.17g km/h, flame length %.17g m, flame angle %.17g deg, %zu strata\n",
+	 expected.ros_kmh, expected.flame_length_m, expected.flame_angle_deg,
+	 ffm_results_num_strata(res));
+  ffm_results_destroy(res);
+
+  pthread_t threads[NUM_THREADS];
+  int ids[NUM_THREADS];
+  for (int t = 0; t < NUM_THREADS; t++) {
+    ids[t] = t;
+    pthread_create(&threads[t], NULL, work, &ids[t]);
+  }
+  for (int t = 0; t < NUM_THREADS; t++) {
+    pthread_join(threads[t], NULL);
+    failed += check(failures[t] == 0, "identical results on every thread");
+  }
+
+  /* failures are reported, never by ending the process */
+  failed += check(ffm_compute(NULL, &res) == FFM_INVALID_ARGUMENT, "null site");
+  failed += check(ffm_site_add_stratum(site, (ffm_level)9, 1, &elevated, 1) == FFM_INVALID_ARGUMENT,
+		  "unknown level");
+  ffm_species_params bad = elevated;
+  bad.leaf_width = -1;
+  ffm_site* invalid = ffm_site_create(&params);
+  ffm_site_add_stratum(invalid, FFM_ELEVATED, 3.9, &bad, 1);
+  failed += check(ffm_compute(invalid, &res) == FFM_INVALID_INPUTS, "invalid species");
+  ffm_site_destroy(invalid);
+  ffm_site_destroy(site);
+
+  printf("%s\n", failed ? "api check failed" : "api check passed");
+  return failed ? 1 : 0;
+}
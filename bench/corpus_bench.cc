@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/resource.h>
+#include "location.h"
+#include "input_document.h"
+#include "ffm_io.h"
+#include "ffm_util.h"
+
+/*
+  End to end throughput benchmark over a corpus of input files (typically the .txt files of data/).
+
+  Every file is read once, then the whole corpus is run in each of four modes: at the
+  basic, detailed and comprehensive output levels, where a scenario is building the
+  Location, calling Location::results() for that level and printing the report, and in
+  Monte Carlo mode, where a scenario is one iteration of resampling the inputs with a
+  generator keyed by the seed and the iteration number (as 'ffm --seed'), computing
+  the results and printing the Monte Carlo row. With --repeat the corpus is run that
+  many times and the fastest time of each site is kept.
+
+  The time of each site in each mode is printed, then for each mode the number of
+  scenarios per second over the corpus and percentiles of the site times, and the peak
+  resident set size of the process. Files that cannot be read or that fail in the
+  model are reported and left out.
+
+  --write-baseline saves the throughput of each mode, one "mode = scenarios per second"
+  line each, and a "build = compiler and flags" line. --baseline compares against such
+  a file, and the benchmark exits with status 1 if the throughput of any mode has fallen
+  by more than the threshold, 10% by default, from its baseline, or if the baseline was
+  built with another compiler or flags.
+
+  usage: corpus_bench input_file [input_file ...] [--repeat n] [--mc-iterations n]
+                      [--seed s] [--baseline file] [--threshold percent]
+                      [--write-baseline file] [--quiet]
+*/
+
+//the compiler and flags of the benchmark build, given by the Makefile
+#ifndef FFM_BENCH_FLAGS
+#define FFM_BENCH_FLAGS "unknown"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+  double elapsedMs(const Clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  }
+
+  const std::vector<std::string> MODES = {"basic", "detailed", "comprehensive", "monte_carlo"};
+
+  struct Site {
+    std::string path;
+    InputDocument doc;
+    SiteInputs inputs;
+    std::vector<double> ms;  //fastest time of the site in each mode
+    std::string failure;
+  };
+
+  //runs one site in one mode, returning the number of scenarios
+  int runSite(Site& site, const size_t& mode, const int& mcIterations, const unsigned long long& seed,
+	      std::string& out) {
+    if (mode < 3) {
+      Results::OutputLevelType level = static_cast<Results::OutputLevelType>(mode);
+      Results res = buildLocation(site.inputs).results(level);
+      out = res.printToString(level);
+      return 1;
+    }
+    //as in ffm, an iteration whose sampled inputs are unusable draws again, giving up
+    //after a number of attempts so that a site whose inputs are always rejected ends
+    SiteInputs inputs;
+    int numIter = 0;
+    for (int i = 0; i < mcIterations; ++i) {
+      ffm_util::seedRandom(seed, i);
+      for (int attempt = 0; attempt < 100; ++attempt) {
+	Location loc = resolveSiteInputs(site.doc, true, inputs) ? buildLocation(inputs) : Location();
+	if (loc.empty()) continue;
+	out = printMonteCarloInputs(loc) + printMonteCarloResults(loc.results(Results::MONTE_CARLO));
+	++numIter;
+	break;
+      }
+    }
+    if (numIter == 0) throw std::runtime_error("no usable Monte Carlo samples");
+    return numIter;
+  }
+
+  double percentile(std::vector<double> values, const double& p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, size_t(p*values.size()))];
+  }
+
+}
+
+int main(int argc, char* argv[]) {
+
+  std::string usage("usage: corpus_bench input_file [input_file ...] [--repeat n] [--mc-iterations n]\n"
+		    "                    [--seed s] [--baseline file] [--threshold percent]\n"
+		    "                    [--write-baseline file] [--quiet]");
+  std::vector<std::string> paths;
+  int repeat = 1, mcIterations = 10;
+  unsigned long long seed = 1;
+  double threshold = 10;
+  std::string baselinePath, writeBaselinePath;
+  bool quiet = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "--repeat" && i + 1 < argc)
+      repeat = atoi(argv[++i]);
+    else if (arg == "--mc-iterations" && i + 1 < argc)
+      mcIterations = atoi(argv[++i]);
+    else if (arg == "--seed" && i + 1 < argc)
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    else if (arg == "--baseline" && i + 1 < argc)
+      baselinePath = argv[++i];
+    else if (arg == "--threshold" && i + 1 < argc)
+      threshold = atof(argv[++i]);
+    else if (arg == "--write-baseline" && i + 1 < argc)
+      writeBaselinePath = argv[++i];
+    else if (arg == "--quiet")
+      quiet = true;
+    else
+      paths.push_back(arg);
+  }
+  if (paths.empty() || repeat < 1 || mcIterations < 1) {
+    std::cout << usage << std::endl;
+    return 1;
+  }
+
+  std::vector<Site> sites;
+  for (const std::string& path : paths) {
+    Site site;
+    site.path = path;
+    site.ms.assign(MODES.size(), 0);
+    try {
+      site.doc = parseInputDocument(path);
+      resolveSiteInputs(site.doc, false, site.inputs);
+    }
+    catch (const std::exception& e) {
+      site.failure = e.what();
+    }
+    sites.push_back(std::move(site));
+  }
+
+  //total time and number of scenarios of each mode, from the fastest pass over the corpus
+  std::vector<double> totalMs(MODES.size(), 0);
+  std::vector<long> numScenarios(MODES.size(), 0);
+  std::string out;
+  for (int r = 0; r < repeat; ++r) {
+    for (size_t m = 0; m < MODES.size(); ++m) {
+      double passMs = 0;
+      long passScenarios = 0;
+      for (Site& site : sites) {
+	if (!site.failure.empty()) continue;
+	Clock::time_point start = Clock::now();
+	try {
+	  passScenarios += runSite(site, m, mcIterations, seed, out);
+	}
+	catch (const std::exception& e) {
+	  site.failure = e.what();
+	  continue;
+	}
+	double ms = elapsedMs(start);
+	passMs += ms;
+	site.ms[m] = r == 0 ? ms : std::min(site.ms[m], ms);
+      }
+      if (r == 0 || passMs < totalMs[m]) {
+	totalMs[m] = passMs;
+	numScenarios[m] = passScenarios;
+      }
+    }
+  }
+
+  char buff[512];
+  if (!quiet) {
+    std::cout << "site";
+    for (const std::string& mode : MODES) std::cout << "," << mode << " (ms)";
+    std::cout << std::endl;
+  }
+  std::vector<std::vector<double>> siteMs(MODES.size());
+  int numFailed = 0;
+  for (const Site& site : sites) {
+    if (!site.failure.empty()) {
+      std::cout << site.path << ",failed: " << site.failure << std::endl;
+      ++numFailed;
+      continue;
+    }
+    if (!quiet) std::cout << site.path;
+    for (size_t m = 0; m < MODES.size(); ++m) {
+      if (!quiet) {
+	sprintf(buff, ",%.3f", site.ms[m]);
+	std::cout << buff;
+      }
+      siteMs[m].push_back(m < 3 ? site.ms[m] : site.ms[m]/mcIterations);
+    }
+    if (!quiet) std::cout << std::endl;
+  }
+
+  std::cout << std::endl << sites.size() - numFailed << " sites, " << numFailed << " failed, best of "
+	    << repeat << (repeat == 1 ? " pass" : " passes") << ", " << mcIterations
+	    << " Monte Carlo iterations per site, seed " << seed << std::endl
+	    << "built with " << FFM_BENCH_FLAGS << std::endl;
+  sprintf(buff, "%-16s %14s %12s %12s %12s\n", "mode", "scenarios/s", "p50 ms", "p90 ms", "max ms");
+  std::cout << buff;
+  std::map<std::string, double> throughput;
+  for (size_t m = 0; m < MODES.size(); ++m) {
+    throughput[MODES[m]] = totalMs[m] > 0 ? 1000*numScenarios[m]/totalMs[m] : 0;
+    sprintf(buff, "%-16s %14.2f %12.3f %12.3f %12.3f\n", MODES[m].c_str(), throughput[MODES[m]],
+	    percentile(siteMs[m], 0.5), percentile(siteMs[m], 0.9), percentile(siteMs[m], 1.0));
+    std::cout << buff;
+  }
+  struct rusage usage_;
+  getrusage(RUSAGE_SELF, &usage_);
+  std::cout << "peak RSS " << usage_.ru_maxrss/1024.0 << " MB" << std::endl;
+
+  if (!writeBaselinePath.empty()) {
+    std::ofstream base(writeBaselinePath);
+    base << "# scenarios per second, written by corpus_bench" << std::endl
+	 << "build = " << FFM_BENCH_FLAGS << std::endl;
+    for (const std::string& mode : MODES) {
+      sprintf(buff, "%s = %.4f", mode.c_str(), throughput[mode]);
+      base << buff << std::endl;
+    }
+    if (!base) {
+      std::cout << "Problem writing " << writeBaselinePath << std::endl;
+      return 1;
+    }
+  }
+
+  if (!baselinePath.empty()) {
+    std::string contents = readInputFile(baselinePath);
+    if (contents.empty()) {
+      std::cout << "Problem reading baseline " << baselinePath << std::endl;
+      return 1;
+    }
+    std::string_view rest(contents), line;
+    bool regressed = false;
+    std::string baseBuild = "unknown";
+    std::cout << std::endl << "against " << baselinePath << ", threshold " << threshold << "%" << std::endl;
+    while (ffm_util::nextField(rest, '\n', line)) {
+      line = ffm_util::trimView(line.substr(0, line.find('#')), " \t\r");
+      size_t eq = line.find('=');
+      if (line.empty() || eq == std::string_view::npos) continue;
+      std::string mode(ffm_util::trimView(line.substr(0, eq)));
+      if (mode == "build") {
+	baseBuild = ffm_util::trimView(line.substr(eq + 1));
+	continue;
+      }
+      double base;
+      if (!throughput.count(mode) || !parseDouble(ffm_util::trimView(line.substr(eq + 1)), base) || base <= 0)
+	continue;
+      double change = 100*(throughput[mode] - base)/base;
+      bool failed = change < -threshold;
+      regressed = regressed || failed;
+      sprintf(buff, "%-16s %14.2f baseline %14.2f %+8.1f%% %s\n", mode.c_str(), throughput[mode], base,
+	      change, failed ? "REGRESSED" : "ok");
+      std::cout << buff;
+    }
+    if (baseBuild != FFM_BENCH_FLAGS) {
+      std::cout << "baseline built with " << baseBuild << ", not like for like" << std::endl;
+      return 1;
+    }
+    if (regressed) return 1;
+  }
+
+  return 0;
+}
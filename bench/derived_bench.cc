@@ -0,0 +1,198 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "species.h"
+#include "stratum.h"
+#include "location.h"
+#include "ffm_io.h"
+#include "ffm_settings.h"
+
+/*
+  Microbenchmark for the derived-property blocks of Species and Stratum.
+
+  For each stratum of the input forest the derived quantities used by the model
+  (average width, top, bottom, flame duration, model plant separation, cover and
+  leaf area index, and the species leaf moisture, ignition temperature, flame
+  duration, leaf flame length and leaves per clump) are read repeatedly, once
+  through the cached accessors and once by recomputing them from the species
+  traits as the accessors did before the values were cached. The time taken
+  by one call to Location::results() is reported alongside so that the saving
+  can be judged against the cost of a whole run.
+
+  usage: derived_bench input_file [iterations]
+*/
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+  double elapsedNs(const Clock::time_point& start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  }
+
+  //uncached versions of the species computations
+
+  double leafMoisture(const Species& s) {
+    return (1 - s.propDead())*s.liveLeafMoisture() + s.propDead()*s.deadLeafMoisture();
+  }
+
+  double ignitionTemp(const Species& s) {
+    if (s.silFreeAshCont() < 0 && s.ignitTemp() < 0) return -99;
+    if (s.ignitTemp() < 0)
+      return 354 - 13.9*log(s.silFreeAshCont()*100) - 2.91*pow(log(s.silFreeAshCont()*100),2);
+    return s.ignitTemp();
+  }
+
+  double flameDuration(const Species& s) {
+    return std::max(1.37*s.leafWidth()*s.leafThick()*1.0e6 + 1.61*leafMoisture(s) - 0.027,
+                    ffm_settings::computationTimeInterval);
+  }
+
+  double leafFlameLength(const Species& s) {
+    double area = 0.5*s.leafWidth()*s.leafLength();
+    double sqRootArea = pow(area,0.5);
+    double cubeRootArea = pow(area,1/3.0);
+    if(leafMoisture(s) < (17.5*cubeRootArea - 52.5*sqRootArea - 0.0027)/0.277)
+      return 1.75*cubeRootArea - 0.0277*leafMoisture(s) - 0.00027;
+    return 5.25*sqRootArea;
+  }
+
+  double leavesPerClump(const Species& s) {
+    return 0.88*pow(s.clumpDiam()*s.stemOrder()/s.leafSep(),1.18);
+  }
+
+  double leafAreaIndex(const Species& s) {
+    Poly crown = s.crown();
+    return s.leafWidth()*s.leafLength()/2.0
+      * leavesPerClump(s)
+      * crown.volumeOfRev()
+      / (4.0/3.0*PI*pow((s.clumpDiam() + s.clumpSep())*0.5,3))
+      / (PI*pow(0.5*crown.width(),2));
+  }
+
+  //uncached versions of the stratum computations
+
+  double avWidth(const Stratum& strat) {
+    double av(0);
+    for(const auto& s : strat.allSpecies()) av += s.composition() * Poly(s.crown()).width();
+    return av;
+  }
+
+  double avTop(const Stratum& strat) {
+    double av(0);
+    for(const auto& s : strat.allSpecies()) av += s.composition() * Poly(s.crown()).top();
+    return av;
+  }
+
+  double avBottom(const Stratum& strat) {
+    double av(0);
+    for(const auto& s : strat.allSpecies()) av += s.composition() * Poly(s.crown()).bottom();
+    return av;
+  }
+
+  double avFlameDuration(const Stratum& strat) {
+    double av(0);
+    for(const auto& s : strat.allSpecies()) av += s.composition() * flameDuration(s);
+    return av;
+  }
+
+  double modelPlantSep(const Stratum& strat) {
+    return (strat.plantSep() > avWidth(strat)) ? strat.plantSep() : avWidth(strat);
+  }
+
+  double cover(const Stratum& strat) {
+    return pow(avWidth(strat)/modelPlantSep(strat),2);
+  }
+
+  double leafAreaIndex(const Stratum& strat) {
+    double lai(0);
+    for(const auto& s : strat.allSpecies()) lai += s.composition() * leafAreaIndex(s);
+    return lai * cover(strat);
+  }
+
+  //one sweep over every derived quantity of every stratum and species
+
+  double sweepCached(const std::vector<Stratum>& strata) {
+    double sum = 0;
+    for (const Stratum& strat : strata) {
+      sum += strat.avWidth() + strat.avTop() + strat.avBottom() + strat.avMidHt()
+        + strat.avFlameDuration() + strat.modelPlantSep() + strat.cover() + strat.leafAreaIndex();
+      for (const Species& s : strat.allSpecies())
+        sum += s.leafMoisture() + s.ignitionTemp() + s.flameDuration()
+          + s.leafFlameLength() + s.leavesPerClump();
+    }
+    return sum;
+  }
+
+  double sweepUncached(const std::vector<Stratum>& strata) {
+    double sum = 0;
+    for (const Stratum& strat : strata) {
+      sum += avWidth(strat) + avTop(strat) + avBottom(strat) + 0.5*(avTop(strat) + avBottom(strat))
+        + avFlameDuration(strat) + modelPlantSep(strat) + cover(strat) + leafAreaIndex(strat);
+      for (const Species& s : strat.allSpecies())
+        sum += leafMoisture(s) + ignitionTemp(s) + flameDuration(s)
+          + leafFlameLength(s) + leavesPerClump(s);
+    }
+    return sum;
+  }
+
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 2) {
+    std::cout << "usage: derived_bench input_file [iterations]" << std::endl;
+    return 1;
+  }
+  std::string inPath = argv[1];
+  int numIter = (argc > 2) ? atoi(argv[2]) : 100000;
+  if (numIter <= 0) {
+    std::cout << "iterations must be positive" << std::endl;
+    return 1;
+  }
+
+  Location loc = parseInputTextFile(inPath, false);
+  const std::vector<Stratum>& strata = loc.strata();
+
+  //accumulate into a volatile so the sweeps are not optimised away
+  volatile double sink = 0;
+
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < numIter; ++i) sink = sink + sweepCached(strata);
+  double cachedNs = elapsedNs(start) / numIter;
+
+  start = Clock::now();
+  for (int i = 0; i < numIter; ++i) sink = sink + sweepUncached(strata);
+  double uncachedNs = elapsedNs(start) / numIter;
+
+  //check that the two sweeps agree
+  if (sweepCached(strata) != sweepUncached(strata))
+    std::cout << "warning: cached and recomputed values differ" << std::endl;
+
+  //one complete model run, for scale
+  int numRuns = 5;
+  start = Clock::now();
+  for (int i = 0; i < numRuns; ++i) {
+    Results res = loc.results();
+    sink = sink + res.flameLength();
+  }
+  double runNs = elapsedNs(start) / numRuns;
+
+  char buff[256];
+  sprintf(buff, "%-28s %d strata, %d iterations\n", inPath.c_str(), (int)strata.size(), numIter);
+  std::cout << buff;
+  sprintf(buff, "%-28s %12.1f ns/sweep\n", "cached accessors", cachedNs);
+  std::cout << buff;
+  sprintf(buff, "%-28s %12.1f ns/sweep\n", "recomputed", uncachedNs);
+  std::cout << buff;
+  sprintf(buff, "%-28s %12.2f x\n", "speedup", uncachedNs / cachedNs);
+  std::cout << buff;
+  sprintf(buff, "%-28s %12.1f ms/run\n", "Location::results()", runNs * 1.0e-6);
+  std::cout << buff;
+
+  return 0;
+}
@@ -0,0 +1,283 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "location.h"
+#include "flame.h"
+#include "pre_heating_flame.h"
+#include "ray.h"
+#include "ffm_io.h"
+#include "ffm_settings.h"
+#include "ffm_util.h"
+#include "ffm_alloc.h"
+
+/*
+  Microbenchmarks for the model kernels.
+
+  Each kernel is run with inputs taken from the forest of the input file: ray and
+  crown intersections for the crowns of its species, plume temperatures and their
+  inverse for flames of typical length, species ignition delay times and flame
+  lengths, the wind profile through its strata, flame combination of two series of
+  flames, and one call to Location::computeIgnitionPath as made for the first
+  species of the lowest stratum at the start of Location::results().
+
+  The number of calls in a repetition is doubled until a repetition takes at least
+  10 ms, then the repetitions are timed separately. For each kernel the mean, standard
+  deviation, minimum and maximum of the time per call over the repetitions are
+  reported, with the number of heap allocations per call, which are counted by
+  replacing the global operator new.
+
+  usage: kernel_bench input_file [--repetitions n] [--filter text] [--json file]
+
+  With --filter only the kernels whose names contain text are run. With --json the
+  results are also written to file as a JSON object, for comparison between builds. The
+  compiler and flags of the build are printed and recorded in the JSON object, so that
+  only like builds are compared.
+*/
+
+//the compiler and flags of the benchmark build, given by the Makefile
+#ifndef FFM_BENCH_FLAGS
+#define FFM_BENCH_FLAGS "unknown"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+//the allocation tracking build (make ALLOC_TRACKING=1) already replaces operator new
+#ifdef FFM_ALLOC_TRACKING
+
+namespace {
+
+  unsigned long numAllocations() {return ffm_alloc::threadCounts().allocations;}
+
+}
+
+#else
+
+namespace {
+
+  std::atomic<unsigned long> allocations(0);
+
+  unsigned long numAllocations() {return allocations;}
+
+}
+
+void* operator new(size_t size) {
+  ++allocations;
+  if (void* p = malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+  ++allocations;
+  if (void* p = malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {free(p);}
+void operator delete[](void* p) noexcept {free(p);}
+void operator delete(void* p, size_t) noexcept {free(p);}
+void operator delete[](void* p, size_t) noexcept {free(p);}
+
+#endif
+
+namespace {
+
+  //accumulate into a volatile so the kernels are not optimised away
+  volatile double sink = 0;
+
+  struct Measurement {
+    std::string name;
+    long opsPerRep = 0;
+    double mean = 0, stdDev = 0, min = 0, max = 0;
+    double allocsPerOp = 0;
+  };
+
+  double elapsedNs(const Clock::time_point& start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  }
+
+  //op is called with the number of the call, so that it can cycle through its inputs
+  Measurement measure(const std::string& name, const std::function<double(long)>& op,
+		      const int& repetitions) {
+    const double targetNs = 1.0e7;
+    Measurement m;
+    m.name = name;
+
+    long n = 1;
+    while (true) {
+      Clock::time_point start = Clock::now();
+      for (long i = 0; i < n; ++i) sink = sink + op(i);
+      if (elapsedNs(start) >= targetNs || n >= (1L << 30)) break;
+      n *= 2;
+    }
+    m.opsPerRep = n;
+
+    ffm_util::RunningStats stats;
+    unsigned long allocsBefore = numAllocations();
+    for (int r = 0; r < repetitions; ++r) {
+      Clock::time_point start = Clock::now();
+      for (long i = 0; i < n; ++i) sink = sink + op(i);
+      stats.add(elapsedNs(start)/n);
+    }
+    m.allocsPerOp = double(numAllocations() - allocsBefore)/(double(n)*repetitions);
+    m.mean = stats.mean;
+    m.stdDev = stats.stdDev();
+    m.min = stats.min;
+    m.max = stats.max;
+    return m;
+  }
+
+}
+
+/*!\brief Sets up the kernels, a friend of Location so that computeIgnitionPath can be timed*/
+class KernelBench {
+public:
+
+  static std::vector<std::pair<std::string, std::function<double(long)>>> kernels(const Location& loc) {
+    std::vector<std::pair<std::string, std::function<double(long)>>> ks;
+    const Forest& forest = loc.forest_;
+
+    std::vector<std::shared_ptr<const Species>> species;
+    for (const Stratum& strat : loc.strata())
+      for (const auto& sp : forest.speciesHandles(strat.level())) species.push_back(sp);
+
+    //rays from points across the base of each crown, at angles from 30 to 150 degrees
+    auto rays = std::make_shared<std::vector<std::pair<Ray, const Poly*>>>();
+    for (const auto& sp : species)
+      for (int k = -2; k <= 2; ++k)
+	for (int a = 1; a <= 5; ++a)
+	  rays->emplace_back(Ray(sp->crown().pointInBase(0.25*k*sp->width()), a*PI/6),
+			     &sp->crown());
+    if (!rays->empty())
+      ks.emplace_back("Ray::intersectionLength", [rays](long i) {
+	  const auto& r = (*rays)[i % rays->size()];
+	  return r.first.intersectionLength(*r.second);
+	});
+
+    const double ambient = loc.weather().airTempC();
+    Flame flame(2.0, 60*PI/180, Pt(0,0), 0.5, ffm_settings::mainFlameDeltaTemp);
+    ks.emplace_back("Flame::plumeTemperature", [flame, ambient](long i) {
+	return flame.plumeTemperature(0.1 + 0.05*(i % 200), ambient);
+      });
+    ks.emplace_back("Flame::inversePlumeTemperature", [flame, ambient](long i) {
+	return flame.inversePlumeTemperature(ambient + 10 + 5*(i % 200), ambient);
+      });
+
+    if (!species.empty()) {
+      std::shared_ptr<const Species> sp = species.front();
+      ks.emplace_back("Species::ignitionDelayTime", [sp](long i) {
+	  return sp->ignitionDelayTime(250 + 3*(i % 200));
+	});
+      ks.emplace_back("Species::flameLength", [sp](long i) {
+	  return sp->flameLength(0.005*(1 + i % 200));
+	});
+    }
+
+    const double wind = loc.incidentWindSpeed_;
+    ks.emplace_back("Forest::windProfile", [&forest, wind](long i) {
+	return forest.windProfile(wind, 0.1*(i % 300), i % 2 == 0);
+      });
+
+    //two series of flames as from the surface and a stratum, the second one growing then dying
+    std::vector<Flame> flames1(20, Flame(1.5, 70*PI/180, Pt(0,0), 0, ffm_settings::mainFlameDeltaTemp));
+    std::vector<Flame> flames2;
+    for (int k = 0; k < 20; ++k)
+      flames2.push_back(Flame(0.4*std::min(k + 1, 20 - k), 60*PI/180, Pt(0.1*k, 0.5), 0.2,
+			      ffm_settings::mainFlameDeltaTemp));
+    const double slope = loc.slope(), fireline = loc.firelineLength_;
+    ks.emplace_back("combineFlames", [flames1, flames2, wind, slope, fireline](long) {
+	return combineFlames(flames1, flames2, wind, slope, fireline).front().flameLength();
+      });
+
+    if (!species.empty()) {
+      //the first plant ignition run of Location::forestIgnitionRun
+      const Stratum& strat = loc.strata().front();
+      double surfWind = forest.windProfile(wind, forest.heightForSurfaceWind(), true);
+      double surfLength = forest.surface().flameLength(surfWind);
+      double surfAngle = flameAngle(surfLength, surfWind, slope, fireline);
+      double sfrt = forest.surface().flameResidenceTime();
+      Flame surfFlame(surfLength, surfAngle, Pt(0,0), 0, ffm_settings::mainFlameDeltaTemp);
+      std::vector<Flame> incident(static_cast<int>(round(sfrt/ffm_settings::computationTimeInterval)), surfFlame);
+      std::vector<PreHeatingFlame> preHeating = {PreHeatingFlame(Stratum::SURFACE, surfFlame, 0, sfrt)};
+      std::shared_ptr<const Species> sp = forest.speciesHandles(strat.level()).front();
+      int id = forest.speciesIds(strat.level()).front();
+      double stratWind = forest.windProfile(wind, strat.avMidHt(), true);
+      Pt iPt = sp->crown().pointInBase(0);
+      if (iPt.y() < iPt.x()*tan(slope)) iPt = Pt(iPt.x(), iPt.x()*tan(slope));
+      ks.emplace_back("Location::computeIgnitionPath",
+		      [&loc, incident, preHeating, strat, sp, id, stratWind, iPt](long) {
+	  IgnitionPath path = loc.computeIgnitionPath(incident, true, preHeating, -1, strat.level(),
+						      sp, id, 0, 0, stratWind, iPt);
+	  return path.maxFlameLength();
+	});
+    }
+    return ks;
+  }
+};
+
+int main(int argc, char* argv[]) {
+
+  std::string usage("usage: kernel_bench input_file [--repetitions n] [--filter text] [--json file]");
+  std::string inPath, filter, jsonPath;
+  int repetitions = 10;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    if (arg == "--repetitions" && i + 1 < argc)
+      repetitions = atoi(argv[++i]);
+    else if (arg == "--filter" && i + 1 < argc)
+      filter = argv[++i];
+    else if (arg == "--json" && i + 1 < argc)
+      jsonPath = argv[++i];
+    else if (inPath.empty())
+      inPath = arg;
+  }
+  if (inPath.empty() || repetitions < 2) {
+    std::cout << usage << std::endl;
+    return 1;
+  }
+
+  Location loc = parseInputTextFile(inPath, false);
+
+  std::vector<Measurement> results;
+  char buff[256];
+  sprintf(buff, "%-32s %12s %10s %12s %12s %10s\n", "kernel", "ns/op", "cv %", "min ns/op",
+	  "max ns/op", "allocs/op");
+  std::cout << inPath << ", " << repetitions << " repetitions, built with " << FFM_BENCH_FLAGS
+	    << std::endl << buff;
+  for (const auto& k : KernelBench::kernels(loc)) {
+    if (k.first.find(filter) == std::string::npos) continue;
+    Measurement m = measure(k.first, k.second, repetitions);
+    sprintf(buff, "%-32s %12.1f %10.2f %12.1f %12.1f %10.2f\n", m.name.c_str(), m.mean,
+	    100*m.stdDev/m.mean, m.min, m.max, m.allocsPerOp);
+    std::cout << buff;
+    results.push_back(m);
+  }
+
+  if (!jsonPath.empty()) {
+    std::ofstream out(jsonPath);
+    out << "{\"benchmark\":\"kernel_bench\",\"input\":\"" << inPath << "\",\"build\":\""
+	<< FFM_BENCH_FLAGS << "\",\"repetitions\":" << repetitions << ",\"kernels\":[";
+    for (size_t i = 0; i < results.size(); ++i) {
+      const Measurement& m = results[i];
+      sprintf(buff, "%s{\"name\":\"%s\",\"ops_per_repetition\":%ld,\"ns_per_op\":%.6g,"
+	      "\"ns_per_op_stddev\":%.6g,\"ns_per_op_min\":%.6g,\"ns_per_op_max\":%.6g,"
+	      "\"allocs_per_op\":%.6g}", i ? "," : "", m.name.c_str(), m.opsPerRep, m.mean,
+	      m.stdDev, m.min, m.max, m.allocsPerOp);
+      out << buff;
+    }
+    out << "]}" << std::endl;
+    if (!out) {
+      std::cout << "Problem writing " << jsonPath << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
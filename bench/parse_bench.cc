@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "location.h"
+#include "ffm_io.h"
+#include "ffm_util.h"
+
+/*
+  Benchmark for the input file parser.
+
+  Every input file named on the command line (typically the .txt files of data/) is read
+  into memory and each of its lines is tokenized and its value converted to a
+  number, once with the previous regex based implementation (processLine with
+  trim, substr, split, reduce and transform, then DOUBLE_FORMAT and atof) and
+  once with tokenizeLine and parseDouble. The time taken by parseInputTextFile
+  over the whole corpus, which includes reading the files and constructing the
+  Location objects, is reported alongside.
+
+  usage: parse_bench iterations input_file [input_file ...]
+*/
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+  double elapsedNs(const Clock::time_point& start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+  }
+
+  const std::regex DOUBLE_FORMAT("((\\+|-)?[[:digit:]]+)(\\.(([[:digit:]]+)?))?((e|E)((\\+|-)?)[[:digit:]]+)?");
+
+  //the line processing used before tokenizeLine
+  std::vector<std::string> legacyProcessLine(const std::string& line) {
+    std::vector<std::string> retVal;
+    std::string l;
+    l = ffm_util::trim(line);
+    l = l.substr(0, l.find('#'));
+    if (l.empty())
+      return retVal;
+    std::vector<std::string> strVec = ffm_util::split(l,'=');
+    std::string firstString = ffm_util::reduce(strVec.front());
+    std::transform(firstString.begin(), firstString.end(), firstString.begin(), ::tolower);
+    retVal.push_back(firstString);
+    if (strVec.size() > 1)
+      retVal.push_back(strVec.at(1));
+    return retVal;
+  }
+
+  //one sweep over the lines of the corpus, returning a checksum of the keys and numbers
+  double sweepLegacy(const std::vector<std::string>& lines) {
+    double sum = 0;
+    for (const std::string& line : lines) {
+      std::vector<std::string> strVec = legacyProcessLine(line);
+      if (strVec.empty()) continue;
+      sum += strVec.front().size();
+      if (strVec.size() < 2) continue;
+      std::vector<std::string> fields = ffm_util::split(strVec.back(), ',');
+      if (!fields.empty() && std::regex_match(fields.front(), DOUBLE_FORMAT))
+	sum += atof(fields.front().c_str());
+    }
+    return sum;
+  }
+
+  double sweepTokenizer(const std::vector<std::string_view>& lines) {
+    double sum = 0;
+    std::string key;
+    std::string_view value, first;
+    double x;
+    for (const std::string_view& line : lines) {
+      int numTokens = tokenizeLine(line, key, value);
+      if (numTokens == 0) continue;
+      sum += key.size();
+      if (numTokens < 2) continue;
+      if (ffm_util::nextField(value, ',', first) && parseDouble(first, x))
+	sum += x;
+    }
+    return sum;
+  }
+
+}
+
+int main(int argc, char* argv[]) {
+
+  if (argc < 3) {
+    std::cout << "usage: parse_bench iterations input_file [input_file ...]" << std::endl;
+    return 1;
+  }
+  int numIter = atoi(argv[1]);
+  if (numIter <= 0) {
+    std::cout << "iterations must be positive" << std::endl;
+    return 1;
+  }
+  std::vector<std::string> paths(argv + 2, argv + argc);
+
+  //the corpus, held both as separate strings and as views into the file contents
+  std::vector<std::string> contents, lines;
+  std::vector<std::string_view> views;
+  long numBytes = 0;
+  for (const std::string& path : paths) {
+    contents.push_back(readInputFile(path));
+    numBytes += contents.back().size();
+  }
+  for (const std::string& c : contents) {
+    std::string_view rest(c), line;
+    while (ffm_util::nextField(rest, '\n', line)) {
+      views.push_back(line);
+      lines.push_back(std::string(line));
+    }
+  }
+
+  //accumulate into a volatile so the sweeps are not optimised away
+  volatile double sink = 0;
+
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < numIter; ++i) sink = sink + sweepLegacy(lines);
+  double legacyNs = elapsedNs(start) / numIter;
+
+  start = Clock::now();
+  for (int i = 0; i < numIter; ++i) sink = sink + sweepTokenizer(views);
+  double tokenizerNs = elapsedNs(start) / numIter;
+
+  //check that the two sweeps agree
+  if (sweepLegacy(lines) != sweepTokenizer(views))
+    std::cout << "warning: legacy and tokenizer sweeps differ" << std::endl;
+
+  //complete parses of every file
+  start = Clock::now();
+  for (int i = 0; i < numIter; ++i)
+    for (const std::string& path : paths) {
+      Location loc = parseInputTextFile(path, false);
+      sink = sink + loc.strata().size();
+    }
+  double parseNs = elapsedNs(start) / numIter;
+
+  char buff[256];
+  sprintf(buff, "%d files, %d lines, %ld bytes, %d iterations\n",
+	  (int)paths.size(), (int)lines.size(), numBytes, numIter);
+  std::cout << buff;
+  sprintf(buff, "%-28s %12.1f ns/line\n", "legacy tokenize + convert", legacyNs / lines.size());
+  std::cout << buff;
+  sprintf(buff, "%-28s %12.1f ns/line\n", "tokenizeLine + parseDouble", tokenizerNs / lines.size());
+  std::cout << buff;
+  sprintf(buff, "%-28s %12.2f x\n", "speedup", legacyNs / tokenizerNs);
+  std::cout << buff;
+  sprintf(buff, "%-28s %12.1f us/file\n", "parseInputTextFile", parseNs * 1.0e-3 / paths.size());
+  std::cout << buff;
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+#ifndef IGNITIONCOUNTERS_H
+#define IGNITIONCOUNTERS_H
+
+#include <array>
+#include <cstdio>
+#include <string>
+
+//Statements that maintain IgnitionCounters are wrapped in FFM_COUNT, which removes them
+//entirely unless the model is built with FFM_COUNTERS defined (make COUNTERS=1, the default)
+#ifdef FFM_COUNTERS
+#define FFM_COUNT(...) __VA_ARGS__
+#else
+#define FFM_COUNT(...)
+#endif
+
+/*!\brief Counts of the work done by Location::computeIgnitionPath()
+
+  Each IgnitionPath carries the counts of the call that computed it, and a
+  ForestIgnitionRun accumulates the counts of every call made for it, by stratum.
+  When the counters are compiled out all counts stay zero.
+*/
+struct IgnitionCounters {
+
+  /*!\brief Why the loop over time steps of an ignition path ended*/
+  enum EndReason{MAX_TIME_STEPS, FLAMES_EXTINGUISHED, NO_FURTHER_PATH, NUM_END_REASONS};
+
+#ifdef FFM_COUNTERS
+  static constexpr bool ENABLED = true;
+#else
+  static constexpr bool ENABLED = false;
+#endif
+
+  unsigned long calls = 0;                   //!< calls of computeIgnitionPath
+  unsigned long timeSteps = 0;               //!< time steps executed
+  unsigned long penetrationSteps = 0;        //!< test points tested for ignition
+  unsigned long dryingFlameEvaluations = 0;  //!< plume temperatures of drying flames at test points
+  unsigned long ignitionDelayTimeCalls = 0;  //!< calls of Species::ignitionDelayTime
+  unsigned long rayIntersections = 0;        //!< ray and crown intersection lengths
+  std::array<unsigned long, NUM_END_REASONS> endReasons = {};
+
+  /*!\brief Adds the counts of other to these*/
+  void add(const IgnitionCounters& other) {
+    calls += other.calls;
+    timeSteps += other.timeSteps;
+    penetrationSteps += other.penetrationSteps;
+    dryingFlameEvaluations += other.dryingFlameEvaluations;
+    ignitionDelayTimeCalls += other.ignitionDelayTimeCalls;
+    rayIntersections += other.rayIntersections;
+    for (int k = 0; k < NUM_END_REASONS; ++k) endReasons[k] += other.endReasons[k];
+  }
+
+  /*!\brief Column headings matching printToString()*/
+  static std::string printHeader() {
+    char buff[200];
+    snprintf(buff, sizeof(buff), "%-16s %8s %10s %12s %12s %12s %10s %9s %12s %10s\n", "", "calls",
+	     "steps", "penetration", "drying", "IDT calls", "rays", "max steps", "extinguished",
+	     "exhausted");
+    return buff;
+  }
+
+  /*!\brief Printing
+    \param label Name of the row, such as a stratum
+    \return One row of a table headed by printHeader()
+  */
+  std::string printToString(const std::string& label) const {
+    char buff[200];
+    snprintf(buff, sizeof(buff), "%-16s %8lu %10lu %12lu %12lu %12lu %10lu %9lu %12lu %10lu\n",
+	     label.c_str(), calls, timeSteps, penetrationSteps, dryingFlameEvaluations,
+	     ignitionDelayTimeCalls, rayIntersections, endReasons[MAX_TIME_STEPS],
+	     endReasons[FLAMES_EXTINGUISHED], endReasons[NO_FURTHER_PATH]);
+    return buff;
+  }
+};
+
+#endif //IGNITIONCOUNTERS_H
@@ -3,6 +3,14 @@
 #include "ffm_util.h"
 #include "ignition_path.h"
 
+/*!\brief Shared empty Species
+  \return The Species referred to by paths constructed without one.
+*/
+const std::shared_ptr<const Species>& IgnitionPath::noSpecies() {
+  static const std::shared_ptr<const Species> empty = std::make_shared<const Species>();
+  return empty;
+}
+
 
 /*!\brief Categorises a fire as spreading or not. 
 
@@ -134,8 +142,8 @@ std::string IgnitionPath::printToString() const{
 
   str =  "Path type:                " + ignitionPathTypeStringMap.at(type_) + "\n";
   str += "Level:                    " + levelStringMap.at(level_) + "\n";
-  str += "Species:                  " + species_.name() + "\n";
-  sprintf(s, "Flame duration (sec):     %.2f\n", species_.flameDuration());
+  str += "Species:                  " + species_->name() + "\n";
+  sprintf(s, "Flame duration (sec):     %.2f\n", species_->flameDuration());
   str += std::string(s);
 
   if (hasSegments()) {
@@ -200,7 +208,7 @@ std::string IgnitionPath::printToString() const{
     for (int i = 0; i < numSegments(); i++) {
       Seg seg = ignitedSegments_.at(i);
       sprintf(s, "%d\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\n", 
-          i+1, seg.start().x(), seg.start().y(), seg.end().x(), seg.end().y(), seg.length(), species_.flameLength(seg.length()) );
+          i+1, seg.start().x(), seg.start().y(), seg.end().x(), seg.end().y(), seg.length(), species_->flameLength(seg.length()) );
       str += std::string(s);
     }
   }
@@ -1,10 +1,14 @@
 #ifndef IGNITIONPATH_H
 #define IGNITIONPATH_H
 
+#include <memory>
+
 #include "seg.h"
 #include "stratum.h"
+#include "species_registry.h"
 #include "flame_series.h"
 #include "pre_ignition_data.h"
+#include "ignition_counters.h"
 
 class Species;
 class Flame;
@@ -30,23 +34,29 @@ public:
   //constructors
 
   IgnitionPath();
-  IgnitionPath(const PathType& pathType, const Stratum::LevelType& level, const Species& species, 
-	       const int& startTimeStep);
+  IgnitionPath(const PathType& pathType, const Stratum::LevelType& level, 
+	       const std::shared_ptr<const Species>& species, const int& speciesId,
+	       const int& speciesIndex, const int& startTimeStep);
 
   //accessors 
 
   PathType type() const;
   Stratum::LevelType level() const;
-  Species species() const;
+  const Species& species() const;
+  int speciesId() const;
+  int speciesIndex() const;
   int startTimeStep() const;
   std::vector<Seg> ignitedSegments() const;
   Seg ignitedSegment(const int& i) const;
   std::vector<PreIgnitionData> preIgnitionData() const;
+  const IgnitionCounters& counters() const;
   
   //mutators
   void startTimeStep(const int& startTimeStep);
   void addSegment(const Seg& seg);
   void addPreIgnitionData(const PreIgnitionData& data);
+  void notePreIgnitionTemp(const double& temp);
+  void counters(const IgnitionCounters& counters);
 
   //other methods
 
@@ -91,10 +101,30 @@ private:
 
   PathType type_;
   Stratum::LevelType level_;
-  Species species_;
+  std::shared_ptr<const Species> species_;
+  int speciesId_;
+  int speciesIndex_;
   int startTimeStep_;
   std::vector<Seg> ignitedSegments_;
   std::vector<PreIgnitionData> preIgnitionData_;
+  IgnitionCounters counters_;
+
+  //whether pre-ignition data was computed for the path and its maximum temperature,
+  //known even when the records themselves are not kept
+  bool hasPreIgnitionData_;
+  double maxPreIgnitionTemp_;
+
+  //summary statistics of the ignited segments, kept up to date by addSegment() and sortSegments()
+  double maxSegmentLength_;
+  int indexOfMaxSegment_;
+  double maxFlameLength_;
+  double maxX_;
+  double maxY_;
+
+  void resetSummary();
+  void updateSummary(const int& i);
+
+  static const std::shared_ptr<const Species>& noSpecies();
 };
 
 //map for names of path types (used for printing)
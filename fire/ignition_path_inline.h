@@ -14,32 +14,48 @@
 inline  IgnitionPath::IgnitionPath() : 
   type_(UNKNOWN_PATH),
   level_(Stratum::UNKNOWN_LEVEL), 
-  species_(), 
+  species_(noSpecies()), 
+  speciesId_(SpeciesRegistry::NO_SPECIES),
+  speciesIndex_(-1),
   startTimeStep_(-99), 
   ignitedSegments_(), 
-  preIgnitionData_()
+  preIgnitionData_(),
+  hasPreIgnitionData_(false),
+  maxPreIgnitionTemp_(-DBL_MAX)
   {
     ignitedSegments_.reserve(ffm_settings::maxTimeSteps);
+    resetSummary();
   }
 
 /*!\brief Standard constructor.
   \param pathType
   \param lev
-  \param species
+  \param species The Species through which the path burns. This is shared, not copied.
+  \param speciesId The Forest::speciesRegistry() identifier of species, used to match 
+  plant and stratum paths through the same species.
+  \param speciesIndex The position in Stratum::allSpecies() of the Species of the stratum 
+  from which species was derived.
   \param startTimeStep The time step in which ignition of the first segment occurs.
 */
 inline IgnitionPath::IgnitionPath(const PathType& pathType,
                                   const Stratum::LevelType& lev, 
-                                  const Species& species, 
+                                  const std::shared_ptr<const Species>& species, 
+                                  const int& speciesId,
+                                  const int& speciesIndex,
                                   const int& startTimeStep) : 
   type_(pathType),
   level_(lev),  
-  species_(species),
+  species_(species ? species : noSpecies()),
+  speciesId_(speciesId),
+  speciesIndex_(speciesIndex),
   startTimeStep_(startTimeStep),
   ignitedSegments_(), 
-  preIgnitionData_()
+  preIgnitionData_(),
+  hasPreIgnitionData_(false),
+  maxPreIgnitionTemp_(-DBL_MAX)
   {
     ignitedSegments_.reserve(ffm_settings::maxTimeSteps);
+    resetSummary();
   }
                     
 //accessors 
@@ -57,7 +73,19 @@ inline Stratum::LevelType IgnitionPath::level() const {return level_;}
 /*!\brief The Species
   \return The Species through which the IgnitionPath is burning.
 */
-inline Species IgnitionPath::species() const {return species_;}
+inline const Species& IgnitionPath::species() const {return *species_;}
+
+/*!\brief Identifier of the Species
+  \return The Forest::speciesRegistry() identifier of the Species through which the 
+  IgnitionPath is burning, or SpeciesRegistry::NO_SPECIES for an empty path.
+*/
+inline int IgnitionPath::speciesId() const {return speciesId_;}
+
+/*!\brief Position of the Species in its Stratum
+  \return The position in Stratum::allSpecies() of the Species of the stratum at level() 
+  from which the IgnitionPath's Species was derived, or -1 for an empty path.
+*/
+inline int IgnitionPath::speciesIndex() const {return speciesIndex_;}
 
 /*!\brief Time step of ignition
   \return The time step in which the first segment of the IgnitionPath ignited.
@@ -76,10 +104,14 @@ inline std::vector<Seg> IgnitionPath::ignitedSegments() const {return ignitedSeg
 inline Seg IgnitionPath::ignitedSegment(const int& i) const {return ignitedSegments_.at(i);}
   
 /*!\brief Pre-ignition data (pre-heating, incident flames, and final value)
-  \return The vector of PreIgnitionData instances.
+  \return The vector of PreIgnitionData instances, empty unless the records were kept
+  (see PreIgnitionObserver)
 */
 inline std::vector<PreIgnitionData> IgnitionPath::preIgnitionData() const {return preIgnitionData_;}
 
+/*!\brief Counts of the work done computing the path, zero unless built with FFM_COUNTERS*/
+inline const IgnitionCounters& IgnitionPath::counters() const {return counters_;}
+
 //mutators
 
 /*!\brief Sets the starting time step.
@@ -92,12 +124,31 @@ inline void IgnitionPath::startTimeStep(const int& startTimeStep) {
 /*!\brief Adds a segment to the end of the IgntionPath
   \param seg
 */
-inline void IgnitionPath::addSegment(const Seg& seg) {ignitedSegments_.push_back(seg);} 
+inline void IgnitionPath::addSegment(const Seg& seg) {
+  ignitedSegments_.push_back(seg);
+  updateSummary(numSegments() - 1);
+} 
 
 /*!\brief Adds a pre-ignition data rec
   \param data
 */
-inline void IgnitionPath::addPreIgnitionData(const PreIgnitionData& data) {preIgnitionData_.push_back(data);} 
+inline void IgnitionPath::addPreIgnitionData(const PreIgnitionData& data) {
+  preIgnitionData_.push_back(data);
+  notePreIgnitionTemp(data.temperature());
+} 
+
+/*!\brief Notes pre-ignition data that is not kept
+  \param temp Temperature of the record (C)
+*/
+inline void IgnitionPath::notePreIgnitionTemp(const double& temp) {
+  hasPreIgnitionData_ = true;
+  maxPreIgnitionTemp_ = std::max(maxPreIgnitionTemp_, temp);
+}
+
+/*!\brief Sets the counts of the work done computing the path
+  \param counters
+*/
+inline void IgnitionPath::counters(const IgnitionCounters& counters) {counters_ = counters;}
 
 //other methods
 
@@ -115,20 +166,17 @@ inline bool IgnitionPath::hasSegments() const {
 }
 
 /*!\brief Test for pre-ignition data
-  \return true if there is pre-ignition data
+  \return true if pre-ignition data was computed for the path, whether or not it was kept
 */
 inline bool IgnitionPath::hasPreIgnitionData() const {
-  return !preIgnitionData_.empty();
+  return hasPreIgnitionData_;
 }
 
+/*!\brief Maximum temperature of the pre-ignition data
+  \return The temperature (C), or -DBL_MAX if there is no pre-ignition data
+*/
 inline double IgnitionPath::maxPreIgnitionTemp() const {
-  double t = -DBL_MAX;
-
-  for (const PreIgnitionData& pid : preIgnitionData_) {
-    t = std::max(t, pid.temperature());
-  }
-
-  return t;
+  return maxPreIgnitionTemp_;
 }
 
 /*!\brief Test for IgnitionPath of maximum size
@@ -144,21 +192,56 @@ inline bool IgnitionPath::fullSize() const {
 inline void IgnitionPath::sortSegments() {
   //sorts the segments longest to shortest 
   //note the direction of cmp
-  auto cmp = [](Seg s1, Seg s2){return s1.length() > s2.length();};
+  auto cmp = [](const Seg& s1, const Seg& s2){return s1.length() > s2.length();};
   sort(ignitedSegments_.begin(), 
        ignitedSegments_.end(), 
        cmp);
+  //the maximum values are unchanged but the longest segment may have moved
+  resetSummary();
+  for (int i = 0; i < numSegments(); ++i) updateSummary(i);
 } 
 
+/*!\brief Clears the summary statistics of the ignited segments
+ */
+inline void IgnitionPath::resetSummary() {
+  maxSegmentLength_ = 0;
+  indexOfMaxSegment_ = -1;
+  maxFlameLength_ = 0;
+  maxX_ = 0;
+  maxY_ = 0;
+}
+
+/*!\brief Includes a segment in the summary statistics
+  \param i Index of the segment, which must be the next one not yet included.
+
+  Ties are resolved in favour of the earlier segment, as max_element() does.
+*/
+inline void IgnitionPath::updateSummary(const int& i) {
+  const Seg& seg = ignitedSegments_[i];
+  double x = std::max(seg.start().x(), seg.end().x());
+  double y = std::max(seg.start().y(), seg.end().y());
+  if (i == 0) {
+    maxSegmentLength_ = seg.length();
+    indexOfMaxSegment_ = 0;
+    maxFlameLength_ = species_->flameLength(maxSegmentLength_);
+    maxX_ = x;
+    maxY_ = y;
+    return;
+  }
+  if (maxSegmentLength_ < seg.length()) {
+    maxSegmentLength_ = seg.length();
+    indexOfMaxSegment_ = i;
+    maxFlameLength_ = species_->flameLength(maxSegmentLength_);
+  }
+  if (maxX_ < x) maxX_ = x;
+  if (maxY_ < y) maxY_ = y;
+}
+
 /*!\brief Length of longest segment
   \return The length of the longest segment.
 */
 inline double IgnitionPath::maxSegmentLength() const {
-  if (!hasSegments()) return 0;
-  auto i = max_element(ignitedSegments_.begin(), 
-                       ignitedSegments_.end(), 
-                       [](Seg s1, Seg s2){return s1.length() < s2.length();});
-  return (*i).length();
+  return maxSegmentLength_;
 }
 
 /*!\brief Find the longest segment
@@ -166,11 +249,7 @@ inline double IgnitionPath::maxSegmentLength() const {
   is equal to the maximum segment length.
 */
 inline int IgnitionPath::indexOfMaxSegment() const {
-  if (!hasSegments()) return -1;
-  auto i = max_element(ignitedSegments_.begin(), 
-                       ignitedSegments_.end(), 
-                       [](Seg s1, Seg s2){return s1.length() < s2.length();});
-  return static_cast<int>(std::distance(ignitedSegments_.begin(),i));
+  return indexOfMaxSegment_;
 }
 
 /*!\brief Origin of longest segment
@@ -188,8 +267,8 @@ inline Pt IgnitionPath::originOfMaxSegment() const {
 inline double IgnitionPath::maxHeightBurnt(const double& slope) const {
   if (!hasSegments()) return 0;
   auto i = max_element(ignitedSegments_.begin(), ignitedSegments_.end(), 
-                       [slope](Seg s1, Seg s2){return s1.end().y() - s1.end().x()*tan(slope)  < 
-                                               s2.end().y() - s2.end().x()*tan(slope);});
+                       [slope](const Seg& s1, const Seg& s2){return s1.end().y() - s1.end().x()*tan(slope)  < 
+                                                             s2.end().y() - s2.end().x()*tan(slope);});
   return (*i).end().y() - (*i).end().x()*tan(slope);
 }
 
@@ -197,22 +276,14 @@ inline double IgnitionPath::maxHeightBurnt(const double& slope) const {
   \return The maximum x-coordinate of any part of any ignited segment.
 */
 inline double IgnitionPath::maxX() const {
-  if (!hasSegments()) return 0;
-  auto i = max_element(ignitedSegments_.begin(), ignitedSegments_.end(), 
-                       [](Seg s1, Seg s2){return std::max(s1.start().x(),s1.end().x()) < 
-                                          std::max(s2.start().x(), s2.end().x());});
-  return std::max((*i).start().x(), (*i).end().x());
+  return maxX_;
 }
 
 /*!\brief Maximum y-coordinate
   \return The maximum y-coordinate of any part of any ignited segment.
 */
 inline double IgnitionPath::maxY() const {
-  if (!hasSegments()) return 0;
-  auto i = max_element(ignitedSegments_.begin(), ignitedSegments_.end(), 
-                       [](Seg s1, Seg s2){return std::max(s1.start().y(),s1.end().y()) < 
-                                          std::max(s2.start().y(), s2.end().y());});
-  return std::max((*i).start().y(), (*i).end().y());
+  return maxY_;
 }
 
 /*!\brief Maximum horizontal run
@@ -239,10 +310,7 @@ inline double IgnitionPath::timeToIgnition() const {
 */
 inline int IgnitionPath::timeStepsIgnitionToMaxFlame() const {
   if (!hasSegments()) return 0;
-  auto cmp = [](Seg s1, Seg s2){return s1.length() < s2.length();};
-  return static_cast<int> (std::distance(ignitedSegments_.begin(),
-                                             std::max_element(ignitedSegments_.begin(), 
-                                                              ignitedSegments_.end(), cmp)));
+  return indexOfMaxSegment_;
 }
 
 
@@ -258,8 +326,7 @@ inline double IgnitionPath::timeIgnitionToMaxFlame() const {
   \return The maximum flame length produced by any ignited segment.
 */
 inline double IgnitionPath::maxFlameLength() const {
-  if (!hasSegments()) return 0;
-  return species().flameLength(maxSegmentLength());
+  return maxFlameLength_;
 }
 
 /*!\brief Flame length of last ignited segment
@@ -269,7 +336,7 @@ inline double IgnitionPath::maxFlameLength() const {
 inline double IgnitionPath::flameLength() const {
   //returns the flame length from the most recent ignited segment of the ignition path
   if (!hasSegments()) return 0;
-  return species_.flameLength(ignitedLength());
+  return species_->flameLength(ignitedLength());
 }
   
 /*!\brief Extract a flame length
@@ -277,7 +344,7 @@ inline double IgnitionPath::flameLength() const {
   \return The flame length generated by the i-th segment, counting from 0.
 */
 inline double IgnitionPath::flameLength(const int& i) const {
-  return species_.flameLength(ignitedLength(i));
+  return species_->flameLength(ignitedLength(i));
 }
 
 /*!\brief Length of the last segment.
@@ -326,7 +393,7 @@ inline Flame IgnitionPath::flame(const double& windSpeed, const double& slope) c
                windEffectFlameAngle(flameLength(), windSpeed, slope), 
                origin(), 
                ignitedLength(),
-               level_ == Stratum::NEAR_SURFACE && species_.isGrass() ? 
+               level_ == Stratum::NEAR_SURFACE && species_->isGrass() ? 
                ffm_settings::grassFlameDeltaTemp : ffm_settings::mainFlameDeltaTemp);
 }
 
@@ -343,7 +410,7 @@ inline Flame IgnitionPath::flame(const int& idx, const double& windSpeed, const
                windEffectFlameAngle(flameLength(idx), windSpeed, slope), 
                origin(idx), 
                ignitedLength(idx),
-               level_ == Stratum::NEAR_SURFACE && species_.isGrass() ? 
+               level_ == Stratum::NEAR_SURFACE && species_->isGrass() ? 
                ffm_settings::grassFlameDeltaTemp : ffm_settings::mainFlameDeltaTemp);
 }
 
@@ -1,6 +1,9 @@
 #ifndef PREIGNITIONDATA_H
 #define PREIGNITIONDATA_H
 
+#include <stdexcept>
+#include <string>
+
 #include "flame.h"
 #include "pre_heating_flame.h"
 
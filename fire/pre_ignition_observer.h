@@ -0,0 +1,28 @@
+#ifndef PREIGNITIONOBSERVER_H
+#define PREIGNITIONOBSERVER_H
+
+#include "ignition_path.h"
+
+/*!\brief Receives the pre-ignition data of ignition path computations
+
+  Location::computeIgnitionPath() builds PreIgnitionData records, for the pre-heating
+  and incident flames at the first point tested on each path, only when an observer
+  is attached to the Location with Location::preIgnitionObserver() or the records are
+  to be kept in the paths for comprehensive output. Otherwise the kernel is compiled
+  without them and keeps only the maximum pre-ignition temperature that selects among
+  the plant ignition scenarios.
+
+  Observers may be called from several threads at once when a Location is shared.
+*/
+class PreIgnitionObserver {
+public:
+  virtual ~PreIgnitionObserver() {}
+
+  /*!\brief Called for each record as it is computed
+    \param path The path being computed, which gives its type, level and species
+    \param data
+  */
+  virtual void observe(const IgnitionPath& path, const PreIgnitionData& data) = 0;
+};
+
+#endif //PREIGNITIONOBSERVER_H
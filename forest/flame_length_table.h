@@ -0,0 +1,66 @@
+#ifndef FLAME_LENGTH_TABLE_H
+#define FLAME_LENGTH_TABLE_H
+
+#include <string>
+#include <vector>
+
+#include "stratum.h"
+
+/*!\brief A FlameLengthTable holds the flame lengths of the species of a Stratum, by time step
+
+  There is one row for each Species of the Stratum, in the same order as 
+  Stratum::allSpecies(), and a separate row for the composition-weighted average. 
+  Rows are addressed by the position of a Species, as IgnitionPath::speciesIndex(), 
+  except that species sharing a name share the row of the first of them, so that 
+  their flame lengths are merged as they have always been. 
+  Every row has ffm_settings::maxTimeSteps entries, padded with zeros. A row is 
+  marked as filled once the flame lengths of an ignition path have been entered in 
+  it; a species that has no ignition path keeps an unfilled row.
+
+  The storage is kept when the table is reset, so a table can be reused for each 
+  Stratum without further allocation once it has been sized for the Stratum with the 
+  most species.
+*/
+
+class FlameLengthTable{
+
+public:
+
+  //constructors
+
+  FlameLengthTable();
+
+  //accessors
+
+  int numRows() const;
+  const std::string& name(const int& row) const;
+  bool filled(const int& row) const;
+  const std::vector<double>& flameLengths(const int& row) const;
+  const std::vector<double>& weightedAverage() const;
+
+  //mutators
+
+  void reset(const Stratum& strat);
+  std::vector<double>& fillRow(const int& row);
+  std::vector<double>& spareRow();
+  std::vector<double>& weightedAverage();
+  template <typename UnaryOperation> void transform(UnaryOperation op);
+
+  //other methods
+
+  int row(const int& speciesIndex) const;
+
+private:
+
+  int numRows_;
+  std::vector<std::string> names_;
+  std::vector<int> speciesRows_;
+  std::vector<bool> filled_;
+  std::vector<std::vector<double>> rows_;
+  std::vector<double> weightedAverage_;
+  std::vector<double> spareRow_;
+};
+
+#include "flame_length_table_inline.h"
+
+#endif //FLAME_LENGTH_TABLE_H
@@ -0,0 +1,126 @@
+#ifndef FLAME_LENGTH_TABLE_INLINE_H
+#define FLAME_LENGTH_TABLE_INLINE_H
+
+#include <algorithm>
+
+#include "ffm_settings.h"
+
+//constructors
+
+/*!\brief Default constructor produces a table with no species rows*/
+inline FlameLengthTable::FlameLengthTable() : 
+  numRows_(0), 
+  names_(), 
+  speciesRows_(), 
+  filled_(), 
+  rows_(), 
+  weightedAverage_(ffm_settings::maxTimeSteps, 0),
+  spareRow_(ffm_settings::maxTimeSteps, 0) {}
+
+//accessors
+
+/*!\brief Number of species rows
+  \return The number of Species in the Stratum the table was last reset for.
+*/
+inline int FlameLengthTable::numRows() const {return numRows_;}
+
+/*!\brief Species name
+  \param row
+  \return The name of the Species of row.
+*/
+inline const std::string& FlameLengthTable::name(const int& row) const {return names_.at(row);}
+
+/*!\brief Test for a filled row
+  \param row
+  \return true if and only if flame lengths have been entered for the Species of row.
+*/
+inline bool FlameLengthTable::filled(const int& row) const {return filled_.at(row);}
+
+/*!\brief Flame lengths of a species
+  \param row
+  \return The flame lengths of the Species of row, one per time step.
+*/
+inline const std::vector<double>& FlameLengthTable::flameLengths(const int& row) const {
+  return rows_.at(row);
+}
+
+/*!\brief Weighted average flame lengths
+  \return The composition-weighted average flame lengths, one per time step.
+*/
+inline const std::vector<double>& FlameLengthTable::weightedAverage() const {return weightedAverage_;}
+
+//mutators
+
+/*!\brief Prepares the table for a Stratum
+  \param strat
+
+  Sets one unfilled row for each Species of strat and sets all flame lengths to zero. 
+  Each Species is given the row of the first Species of strat with its name.
+*/
+inline void FlameLengthTable::reset(const Stratum& strat) {
+  const std::vector<Species>& allSpecies = strat.allSpecies();
+  numRows_ = static_cast<int>(allSpecies.size());
+  if (static_cast<int>(rows_.size()) < numRows_) {
+    names_.resize(numRows_);
+    speciesRows_.resize(numRows_);
+    filled_.resize(numRows_);
+    rows_.resize(numRows_, std::vector<double>(ffm_settings::maxTimeSteps, 0));
+  }
+  for (int i = 0; i < numRows_; ++i) {
+    names_[i] = allSpecies[i].name();
+    speciesRows_[i] = i;
+    for (int j = 0; j < i; ++j)
+      if (names_[j] == names_[i]) {
+	speciesRows_[i] = j;
+	break;
+      }
+    filled_[i] = false;
+    std::fill(rows_[i].begin(), rows_[i].end(), 0);
+  }
+  std::fill(weightedAverage_.begin(), weightedAverage_.end(), 0);
+}
+
+/*!\brief Marks a row as filled
+  \param row
+  \return The flame lengths of row, for the caller to enter.
+*/
+inline std::vector<double>& FlameLengthTable::fillRow(const int& row) {
+  filled_.at(row) = true;
+  return rows_.at(row);
+}
+
+/*!\brief Working storage
+  \return A row of ffm_settings::maxTimeSteps entries that is not part of the table, for 
+  flame lengths that contribute to the weighted average but have no row of their own.
+*/
+inline std::vector<double>& FlameLengthTable::spareRow() {return spareRow_;}
+
+/*!\brief Weighted average flame lengths
+  \return The composition-weighted average flame lengths, for the caller to enter.
+*/
+inline std::vector<double>& FlameLengthTable::weightedAverage() {return weightedAverage_;}
+
+/*!\brief Applies an operation to every flame length
+  \param op 
+
+  Replaces each flame length fl in the filled rows and the weighted average row with op(fl).
+*/
+template <typename UnaryOperation> 
+inline void FlameLengthTable::transform(UnaryOperation op) {
+  for (int i = 0; i < numRows_; ++i)
+    if (filled_[i]) std::transform(rows_[i].begin(), rows_[i].end(), rows_[i].begin(), op);
+  std::transform(weightedAverage_.begin(), weightedAverage_.end(), weightedAverage_.begin(), op);
+}
+
+//other methods
+
+/*!\brief Find the row of a species
+  \param speciesIndex The position of the Species in Stratum::allSpecies()
+  \return The row of the first Species with the same name, or -1 if speciesIndex is 
+  not a position in the Stratum.
+*/
+inline int FlameLengthTable::row(const int& speciesIndex) const {
+  return (speciesIndex >= 0 && speciesIndex < numRows_) ? speciesRows_[speciesIndex] : -1;
+}
+
+#endif //FLAME_LENGTH_TABLE_INLINE_H
@@ -21,6 +21,7 @@ Forest::Forest(const Surface& surface, const std::vector<Stratum>& strata, const
     //if the level already exists then return empty strata_ 
     if(!levelCheck.empty() && find(levelCheck.begin(), levelCheck.end(), st.level()) < levelCheck.end()){
       strata_.clear();
+      indexStrata();
       return;
     }
     if(!st.allSpecies().empty()) {
@@ -33,6 +34,7 @@ Forest::Forest(const Surface& surface, const std::vector<Stratum>& strata, const
 
   surface_ = surface;
   strataOverlaps_ = so;
+  indexStrata();
 }
 
 
@@ -48,6 +50,7 @@ Forest::Forest(const Surface& surface, const std::vector<Stratum>& strata)
     //if the level already exists then return empty strata_ 
     if(!levelCheck.empty() && find(levelCheck.begin(), levelCheck.end(), st.level()) < levelCheck.end()){
       strata_.clear();
+      indexStrata();
       return;
     }
     if(!st.allSpecies().empty()) {
@@ -59,28 +62,80 @@ Forest::Forest(const Surface& surface, const std::vector<Stratum>& strata)
     sort (strata_.begin(), strata_.end());
     surface_ = surface;
   }
+  indexStrata();
 }
 
-/*!\brief The level of the next Stratum above thisLevel
-  \param  thisLevel The Stratum::LevelType of the Stratum in question
-  \return The next highest Stratum::LevelType of the Forest
+/*!\brief Builds the level-indexed lookup tables
 
-  If thisLevel does not exist 
-  in the forest, or is the highest level then returns Stratum::UNKNOWN_LEVEL
+  Fills in the position of each Stratum in strata_, the next level up from each level, 
+  the overlap type and vertical association for every pair of levels, and the wind 
+  layers used by windProfile(), then calls indexSpecies(). These tables depend only on 
+  the geometry of the strata and the overlap information, so they are built once when 
+  the Forest is constructed and the corresponding queries become simple lookups.
 */
-Stratum::LevelType Forest::nextLevel(const Stratum::LevelType& thisLevel) const{
-  //relies on the fact that the strata are ordered bottom to top
-  auto i = find_if(strata_.begin(),strata_.end(),
-		   [thisLevel](Stratum s){return s.level() == thisLevel;});
-  if (i == strata_.end())
-    return Stratum::UNKNOWN_LEVEL;
-
-  i = find_if(strata_.begin(), strata_.end(),
-		   [thisLevel](Stratum s){return s.level() > thisLevel;});
-  if (i == strata_.end()) 
-    return Stratum::UNKNOWN_LEVEL;
-  else
-    return (*i).level();
+void Forest::indexStrata() {
+  levelIndex_.fill(-1);
+  nextLevel_.fill(Stratum::UNKNOWN_LEVEL);
+  for (int i = 0; i < static_cast<int>(strata_.size()); ++i) {
+    Stratum::LevelType lev = strata_[i].level();
+    levelIndex_[lev] = i;
+    //relies on the fact that the strata are ordered bottom to top
+    if (i + 1 < static_cast<int>(strata_.size()))
+      nextLevel_[lev] = strata_[i + 1].level();
+  }
+
+  //overlaps must be complete before vertical associations are computed
+  for (int i = 0; i < NUM_LEVELS; ++i) 
+    for (int j = 0; j < NUM_LEVELS; ++j) 
+      overlap_[i][j] = computeStrataOverlap(static_cast<Stratum::LevelType>(i), 
+					    static_cast<Stratum::LevelType>(j));
+  for (int i = 0; i < NUM_LEVELS; ++i) 
+    for (int j = 0; j < NUM_LEVELS; ++j) 
+      verticalAssociation_[i][j] = computeVerticalAssociation(static_cast<Stratum::LevelType>(i), 
+							      static_cast<Stratum::LevelType>(j));
+
+  //the sum of the leaf area indices of a layer gives gamma using Eq 6.8 of Zylstra's thesis
+  for (int c = 0; c < 2; ++c) {
+    windLayers_[c].clear();
+    for (const Layer& layer : layers(c == 1)) {
+      double lai = 0;
+      for (const Stratum::LevelType& lev : layer.levels()) lai += stratum(lev).leafAreaIndex();
+      windLayers_[c].push_back({layer.bottom(), layer.top(), layer.levels().empty(),
+	    1.785*pow(lai,0.372)});
+    }
+  }
+
+  indexSpecies();
+}
+
+/*!\brief Builds the species identifiers and shared copies of the species of each level
+
+  Unlike the tables of indexStrata() these depend on the species traits, including the 
+  dead leaf moisture, so they are rebuilt whenever deadLeafMoisture() is set.
+*/
+void Forest::indexSpecies() {
+  speciesRegistry_ = SpeciesRegistry();
+  for (int i = 0; i < NUM_LEVELS; ++i) {
+    speciesIds_[i].clear();
+    speciesHandles_[i].clear();
+  }
+  for (const Stratum& st : strata_) 
+    for (const Species& sp : st.allSpecies()) {
+      speciesHandles_[st.level()].push_back(std::make_shared<const Species>(sp));
+      speciesIds_[st.level()].push_back(speciesRegistry_.intern(speciesHandles_[st.level()].back()));
+    }
+}
+
+/*!\brief Sets the dead leaf moisture of every species
+  \param dead_leaf_moisture Proportion of oven dried weight
+
+  Only the moisture dependent properties of the species and strata and the species 
+  identifiers are recomputed. The geometry, overlap and wind tables are unchanged, so 
+  a Forest built once can be reused for a range of dead fuel moisture contents.
+*/
+void Forest::deadLeafMoisture(const double& dead_leaf_moisture) {
+  for (Stratum& st : strata_) st.deadLeafMoisture(dead_leaf_moisture);
+  indexSpecies();
 }
 
 /*!\brief The bands (layers) of constant forest composition
@@ -122,17 +177,18 @@ std::vector<Layer> Forest::layers(const bool& includeCanopy) const {
   return returnVec;
 }
 
-/*!\brief Find the Forest::StrataOverlapType associated with level1 and level2.
+/*!\brief Computes the Forest::StrataOverlapType associated with level1 and level2.
   \param level1
   \param level2
   \return If strataOverlaps() returns a Forest::StrataOverlap associated with level1 and level2 then
   the associated Forest::StrataOverlapType is returned. Returns Forest::AUTO_CALC_OVERLAP if there is 
   no Forest::StrataOverlap associated with level1 and level2. 
 
-  Order of level1 and level2 is not important. 
+  Order of level1 and level2 is not important. Used by indexStrata() to build the table 
+  read by strataOverlap().
 */
-Forest::StrataOverlapType Forest::strataOverlap(const Stratum::LevelType& level1, 
-						const Stratum::LevelType& level2) const {
+Forest::StrataOverlapType Forest::computeStrataOverlap(const Stratum::LevelType& level1, 
+						       const Stratum::LevelType& level2) const {
   //this method returns the overlap type for two strata (supplied as parameters). If there is no element
   //in strataOverlaps with these levels, some defaults are applied.
   Stratum::LevelType lev1 = level1;
@@ -151,7 +207,7 @@ Forest::StrataOverlapType Forest::strataOverlap(const Stratum::LevelType& level1
     return (((lev2 - lev1) <= 2) ? AUTO_CALC_OVERLAP : OVERLAPPED);
 }
 
-  /*!\brief Determines whether the Stratum at level1 can exist under the Stratum at level2
+  /*!\brief Computes whether the Stratum at level1 can exist under the Stratum at level2
     \param level1
     \param level2
     \return true if and only if the Stratum at the lower of level1 and level2 can exist
@@ -162,46 +218,24 @@ Forest::StrataOverlapType Forest::strataOverlap(const Stratum::LevelType& level1
     level1 can exist under level2 based on the value of 
     Forest::strataOverlap(const Stratum::LevelType& level1, const Stratum::LevelType& level2) const. If this value is 
     Forest::AUTO_CALC_OVERLAP then the function returns true if Stratum::avTop() of the lower
-    level is less than Stratum::avBottom() of the upper level.
+    level is less than Stratum::avBottom() of the upper level. Used by indexStrata() to build 
+    the table read by verticalAssociation().
   */
-bool Forest::verticalAssociation(const Stratum::LevelType& level1, const Stratum::LevelType& level2) const {
+bool Forest::computeVerticalAssociation(const Stratum::LevelType& level1, 
+					const Stratum::LevelType& level2) const {
   Stratum::LevelType lev1 = level1;
   Stratum::LevelType lev2 = level2;
   if (lev2 < lev1) std::swap(lev1,lev2);
-  if (strataOverlap(lev1, lev2) == Forest::OVERLAPPED)
+  StrataOverlapType overlap = computeStrataOverlap(lev1, lev2);
+  if (overlap == Forest::OVERLAPPED)
     return true;
-  else if (strataOverlap(lev1, lev2) == Forest::NOT_OVERLAPPED)
+  else if (overlap == Forest::NOT_OVERLAPPED)
     return false;
-  else if (strataOverlap(lev1, lev2) == Forest::AUTO_CALC_OVERLAP) {
+  else 
     return stratum(lev1).avTop() <= stratum(lev2).avBottom(); 
-  }
 }
 
 
-/*!\brief Extracts the Stratum at a prescribed Stratum::LevelType
-  \param lev The Stratum::LevelType of the Stratum that is required
-  \return The Stratum object corresponding to level. 
-
-  If lev is not contained in the Forest then returns default empty stratum.
-*/
-Stratum Forest::stratum(const Stratum::LevelType& lev) const {
-  auto i = find_if(strata_.begin(),strata_.end(), [lev](const Stratum& s){return s.level() == lev;});
-  if (i == strata_.end()){
-    Stratum tmp;
-    return tmp;
-  } else
-    return *i;
-}
-
-/*!\brief Tests for the existence of a prescribed Stratum::LevelType in the Forest
-  \param lev 
-  \return true if and only if the Forest contains a Stratum with Stratum::LevelType equal to lev.
-*/
-bool Forest::hasLevel(const Stratum::LevelType& lev) const {
-  for (Stratum s : strata_) if (s.level() == lev) return true;
-  return false;
-}
-
 std::string overlapToString(const Forest::StrataOverlap& s){
   std::string str;
   str = levelStringMap.at(std::get<0>(s)) + " " +levelStringMap.at(std::get<1>(s)) + " : " 
@@ -234,9 +268,9 @@ double Forest::windProfile(const double& w, const double& z, const bool& include
   double zz = z;
   if ( zz < ffm_settings::minHeightForWindComp ) zz = ffm_settings::minHeightForWindComp;
 
-  std::vector<Layer> theLayers = layers(includeCanopy);
+  const std::vector<WindLayer>& theLayers = windLayers_[includeCanopy ? 1 : 0];
 
-  if (theLayers.empty() || zz >= theLayers.front().top()) 
+  if (theLayers.empty() || zz >= theLayers.front().top) 
     return w;
 
   //lambda to compute the wind field within a layer that has strata
@@ -248,36 +282,34 @@ double Forest::windProfile(const double& w, const double& z, const bool& include
 
   //refW and refZ store the wind speed and height at the top of the current layer
   double refW = w;
-  double refZ = theLayers.front().top();
+  double refZ = theLayers.front().top;
 
   //loop over the layers, updating refW and refZ as we go. If z is in a layer
   //compute the windspeed at that height and return
 
   for (auto i = theLayers.begin(); i != theLayers.end(); ++i){
 
-    if ( (*i).levels().empty() ) {
+    if ( (*i).empty ) {
       //empty layer, we assume no loss in windspeed
 
       //if zz is in the layer return refW 
-      if (zz >= (*i).bottom()) return refW;
+      if (zz >= (*i).bottom) return refW;
 
       //if zz is not in the layer update the value of refZ,but refW stays the same
-      refZ = (*i).bottom();
+      refZ = (*i).bottom;
 
     } else {
-      //the layer is not empty, so compute the sum of the lai's of the strata in the layer, and 
-      //use this to compute gamma
-      double lai = 0;
-      for ( const Stratum::LevelType& lev : (*i).levels()) lai += stratum(lev).leafAreaIndex();
-      double gamma = 1.785*pow(lai,0.372);
+      //the layer is not empty, so use the gamma found from the sum of the lai's of the 
+      //strata in the layer
+      double gamma = (*i).gamma;
 
       //if zz is in the layer then return the wind speed at zz
-      if (zz >= (*i).bottom()) return f(zz, refW, refZ, gamma);
+      if (zz >= (*i).bottom) return f(zz, refW, refZ, gamma);
 
       //otherwise z is not in the layer so compute the wind speed at the bottom of the layer
       //and update refW and refZ
-      refW = f((*i).bottom(), refW, refZ, gamma);
-      refZ = (*i).bottom();
+      refW = f((*i).bottom, refW, refZ, gamma);
+      refZ = (*i).bottom;
     }
   }
 }
@@ -1,11 +1,14 @@
 #ifndef FOREST_H
 #define FOREST_H
 
+#include <array>
+#include <memory>
 #include <tuple>
 #include <string>
 
 #include "surface.h" 
 #include "stratum.h"
+#include "species_registry.h"
 
 class Layer;
 class Stratum;
@@ -43,14 +46,22 @@ public:
   //accessors
 
   Surface surface() const;
-  std::vector<Stratum> strata() const;
+  const std::vector<Stratum>& strata() const;
   std::vector<StrataOverlap> strataOverlaps() const;
+  const SpeciesRegistry& speciesRegistry() const;
+
+  //mutators
+
+  void surface(const Surface& surface);
+  void deadLeafMoisture(const double& deadLeafMoisture);
 
   //other methods
 
   Stratum::LevelType nextLevel(const Stratum::LevelType& thisLevel) const;
   std::vector<Layer> layers(const bool& includeCanopy = true) const;
-  Stratum stratum(const Stratum::LevelType& level) const;
+  const Stratum& stratum(const Stratum::LevelType& level) const;
+  const std::vector<int>& speciesIds(const Stratum::LevelType& level) const;
+  const std::vector<std::shared_ptr<const Species>>& speciesHandles(const Stratum::LevelType& level) const;
   bool empty() const;
   bool hasLevel(const Stratum::LevelType& level) const; 
   StrataOverlapType strataOverlap(const Stratum::LevelType& level1,
@@ -65,10 +76,43 @@ public:
 
 private:
 
+  //number of distinct values of Stratum::LevelType, excluding UNKNOWN_LEVEL
+  static const int NUM_LEVELS = Stratum::CANOPY + 1;
+
   Surface surface_;
   std::vector<Stratum> strata_;
   std::vector<StrataOverlap> strataOverlaps_;
 
+  //lookup tables indexed by Stratum::LevelType, filled in by indexStrata()
+  std::array<int, NUM_LEVELS> levelIndex_;
+  std::array<Stratum::LevelType, NUM_LEVELS> nextLevel_;
+  std::array<std::array<StrataOverlapType, NUM_LEVELS>, NUM_LEVELS> overlap_;
+  std::array<std::array<bool, NUM_LEVELS>, NUM_LEVELS> verticalAssociation_;
+
+  //species identifiers and shared copies of the species of each level, in the 
+  //same order as Stratum::allSpecies(), filled in by indexSpecies()
+  SpeciesRegistry speciesRegistry_;
+  std::array<std::vector<int>, NUM_LEVELS> speciesIds_;
+  std::array<std::vector<std::shared_ptr<const Species>>, NUM_LEVELS> speciesHandles_;
+
+  /*!\brief A band of layers(), top to bottom, with the wind decay exponent of its strata*/
+  struct WindLayer {
+    double bottom;
+    double top;
+    bool empty;
+    double gamma;
+  };
+
+  //the wind layers without (index 0) and with (index 1) the canopy, filled in by indexStrata()
+  std::array<std::vector<WindLayer>, 2> windLayers_;
+
+  void indexStrata();
+  void indexSpecies();
+  static bool validLevel(const Stratum::LevelType& level);
+  StrataOverlapType computeStrataOverlap(const Stratum::LevelType& level1,
+					 const Stratum::LevelType& level2) const;
+  bool computeVerticalAssociation(const Stratum::LevelType& level1, 
+				  const Stratum::LevelType& level2) const;
 };
 
 
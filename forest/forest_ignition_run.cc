@@ -1,13 +1,39 @@
 #include <algorithm>
+#include <functional>
 
 #include "forest_ignition_run.h"
 #include "ffm_util.h"
 #include "results.h"
 
-// Initialize static key string used with map returned by speciesWeightedFlameLengths
-// and laterallyMergedSpeciesWeightedPlantFlameLengths.
-//
-const std::string ForestIgnitionRun::KEY_WEIGHTED_AVERAGE("WEIGHTED_AVERAGE");
+/*!\brief Updates the index of ignition paths for a path just inserted
+  \param i The position in paths_ at which the path was inserted
+
+  The index records the position of each IgnitionPath in paths_ under its level and path 
+  type, and the position of the first path for each (level, path type, species) key, so 
+  that queries need not scan all the paths. Positions at or after i are moved up by one, 
+  which is nothing to do when the path was appended, as it is when the strata are added
+  in order.
+*/
+void ForestIgnitionRun::indexPath(const int& i) {
+  if (i + 1 < static_cast<int>(paths_.size())) {
+    for (auto& byType : pathIndices_)
+      for (auto& indices : byType)
+        for (auto j = std::lower_bound(indices.begin(), indices.end(), i); j != indices.end(); ++j) 
+          ++*j;
+    for (auto& entry : pathIndex_)
+      if (entry.second >= i) ++entry.second;
+  }
+
+  const IgnitionPath& ip = paths_[i];
+  if (ip.level() < Stratum::SURFACE || ip.level() >= NUM_LEVELS ||
+      ip.type() < 0 || ip.type() >= NUM_PATH_TYPES) 
+    return;
+  std::vector<int>& indices = pathIndices_[ip.level()][ip.type()];
+  indices.insert(std::lower_bound(indices.begin(), indices.end(), i), i);
+  //the path replaces an entry for its key only if it comes first
+  auto entry = pathIndex_.insert(std::make_pair(PathKey(ip.level(), ip.type(), ip.speciesId()), i));
+  if (!entry.second && entry.first->second > i) entry.first->second = i;
+}
 
 
 /*!\brief Determines whether the fire spreads in a particular Stratum
@@ -17,8 +43,8 @@ const std::string ForestIgnitionRun::KEY_WEIGHTED_AVERAGE("WEIGHTED_AVERAGE");
   equal to lev that is classified as spreading
 */
 bool ForestIgnitionRun::spreadsInStratum(const Stratum::LevelType& lev) const {
-  for (const auto& ip : paths_) {
-    if (ip.level() != lev || ip.type() != IgnitionPath::STRATUM_PATH) continue;
+  for (int i : pathIndices(lev, IgnitionPath::STRATUM_PATH)) {
+    const IgnitionPath& ip = paths_[i];
     if (ip.spreads() && ip.species().composition() > 0) return true;
   }
   return false;
@@ -28,45 +54,43 @@ bool ForestIgnitionRun::spreadsInStratum(const Stratum::LevelType& lev) const {
 /*!\brief Composition-weighted flame lengths
   \param lev
   \param ptype
-  \return Composition-weighted flame lengths for all species with Stratum::LevelType equal to lev 
-  and IgnitionPath::PathType equal to ptype. Flame lengths are sorted in decreasing order before 
-  weighted sum is taken. The results are returned as a map with keys for species names (individual
-  species flame lengths used for averaging) and KEY_WEIGHTED_AVERAGE (weighted average flame
-  lengths).
-*/
-std::map<std::string, std::vector<double>>  ForestIgnitionRun::speciesWeightedFlameLengths(
-    const Stratum::LevelType& lev, 
-    const IgnitionPath::PathType& ptype) const {
-
-  std::map<std::string, std::vector<double>> res;
+  \param table Reset for the Stratum at lev and filled with the flame lengths.
   
-  std::vector<double> weightedLengths(ffm_settings::maxTimeSteps, 0);
-
-  for (IgnitionPath ip : paths_) {
-    if (ip.level() == lev && ip.type() == ptype) {
-      std::vector<double> spLengths;
-
-      if (ip.hasSegments()) {
-        double comp = ip.species().composition();
-        double flen;
-        ip.sortSegments();
-        for (int i = 0; i < ip.numSegments(); ++i) {
-          flen = ip.flameLength(i);
-          spLengths.push_back( flen );
-          weightedLengths.at(i) += comp * flen;
-        }
-      } else {
-        // no ignition - but we still want to record a zero height for the species
-        spLengths.push_back( 0.0 );
+  Fills table with the composition-weighted flame lengths for all species with Stratum::LevelType 
+  equal to lev and IgnitionPath::PathType equal to ptype. Flame lengths are sorted in decreasing 
+  order before the weighted sum is taken. The row of each species with an ignition path holds 
+  the individual species flame lengths used for averaging (a single zero if there was no 
+  ignition), and the weighted average row holds the weighted average flame lengths.
+*/
+void ForestIgnitionRun::speciesWeightedFlameLengths(const Stratum::LevelType& lev, 
+                                                    const IgnitionPath::PathType& ptype,
+                                                    FlameLengthTable& table) const {
+
+  table.reset(forest_.stratum(lev));
+  std::vector<double>& weightedLengths = table.weightedAverage();
+
+  for (int idx : pathIndices(lev, ptype)) {
+    const IgnitionPath& ip = paths_[idx];
+
+    //each species keeps the flame lengths of its first path, later paths contribute only 
+    //to the weighted average
+    int row = table.row(ip.speciesIndex());
+    std::vector<double>& spLengths = (row >= 0 && !table.filled(row)) ? 
+      table.fillRow(row) : table.spareRow();
+
+    if (ip.hasSegments()) {
+      double comp = ip.species().composition();
+      int n = ip.numSegments();
+      //segment lengths in decreasing order, as IgnitionPath::sortSegments() would leave them
+      for (int i = 0; i < n; ++i) spLengths[i] = ip.ignitedLength(i);
+      std::sort(spLengths.begin(), spLengths.begin() + n, std::greater<double>());
+      for (int i = 0; i < n; ++i) {
+        spLengths[i] = ip.species().flameLength(spLengths[i]);
+        weightedLengths.at(i) += comp * spLengths[i];
       }
-
-      res.insert( std::pair<std::string, std::vector<double>>(ip.species().name(), spLengths) );
-    }
+    } 
+    // otherwise no ignition - the row is left as zeros, recording a zero height for the species
   }
-
-  res.insert( std::pair<std::string, std::vector<double>>(KEY_WEIGHTED_AVERAGE, weightedLengths) );
-  
-  return res;
 }
 
 /*
@@ -79,11 +103,8 @@ std::map<std::string, std::vector<double>>  ForestIgnitionRun::speciesWeightedFl
 double ForestIgnitionRun::highestFlameOriginY(const Stratum::LevelType& level, const IgnitionPath::PathType& ptype) const {
   double highest = 0;
 
-  for (IgnitionPath ip : paths_) {
-    if (ip.level() == level && ip.type() == ptype) {
-      highest = std::max(highest, ip.maxY());
-    }
-  }
+  for (int i : pathIndices(level, ptype)) 
+    highest = std::max(highest, paths_[i].maxY());
 
   return highest;
 }
@@ -91,43 +112,33 @@ double ForestIgnitionRun::highestFlameOriginY(const Stratum::LevelType& level, c
   /*!\brief Lateral merging and combination of plant ignition paths
     \param lev The Stratum::LevelType of the Stratum under consideration
     \param firelineLen Length of the fire line (m)
-    \return Laterally merged composition-weighted plant flame lengths
+    \param table Reset for the Stratum at lev and filled with the laterally merged 
+    composition-weighted plant flame lengths
 
     Finds each IgnitionPath object of type IgnitionPath::PLANT_PATH in the Stratum with 
     Stratum::LevelType equal to lev, 
     computes the vector of laterally merged flame lengths from each of these ignition paths, 
-    sorts these vectors in order of decreasing size, and returns their 
+    sorts these vectors in order of decreasing size, and forms their 
     composition-weighted component-wise sum.
   */
-std::map<std::string, std::vector<double>>  ForestIgnitionRun::laterallyMergedSpeciesWeightedPlantFlameLengths(
-    const Stratum::LevelType& lev, 
-    const double& firelineLen) const {
-
+void ForestIgnitionRun::laterallyMergedSpeciesWeightedPlantFlameLengths(const Stratum::LevelType& lev, 
+                                                                        const double& firelineLen,
+                                                                        FlameLengthTable& table) const {
 
   // Get basic species weighted flame lengths.
-  // Returned map contains vector of weighted lengths plus N
-  // vectors of contributing flame lengths for the N species
-  // in the stratum.
-  std::map<std::string, std::vector<double>> flameLengths = speciesWeightedFlameLengths(lev, IgnitionPath::PLANT_PATH);
+  // The table contains the weighted lengths plus a row of
+  // contributing flame lengths for each species in the stratum.
+  speciesWeightedFlameLengths(lev, IgnitionPath::PLANT_PATH, table);
 
-  Stratum strat = forest_.stratum(lev);
-  double w = forest_.stratum(lev).avWidth();
-  double sep = forest_.stratum(lev).modelPlantSep();
+  const Stratum& strat = forest_.stratum(lev);
+  double w = strat.avWidth();
+  double sep = strat.modelPlantSep();
 
   // Do lateral merging of both the weighted average flame lengths, and the
   // the individual species flame lengths. Note we use the stratum plant
   // separation parameter for both average and species lengths here.
-  for (std::map<std::string, std::vector<double>>::iterator it = flameLengths.begin();
-      it != flameLengths.end(); ++it) {
-
-    std::vector<double>& flens = it->second;
-
-    transform(flens.begin(), flens.end(), flens.begin(), 
-        [firelineLen, w, sep](const double& fl) {
-        return fl > 0? laterallyMergedFlameLength(fl, firelineLen, w, sep) : 0;});
-  }
-
-  return flameLengths;
+  table.transform([firelineLen, w, sep](const double& fl) {
+      return fl > 0? laterallyMergedFlameLength(fl, firelineLen, w, sep) : 0;});
 }
 
 /*!\brief Average rate of spread
@@ -137,8 +148,8 @@ std::map<std::string, std::vector<double>>  ForestIgnitionRun::laterallyMergedSp
 */
 double ForestIgnitionRun::speciesWeightedBasicROS(const Stratum::LevelType& lev) const {
   double returnValue = 0;
-  for (const IgnitionPath& ip : paths_) {
-    if (ip.level() != lev || ip.type() != IgnitionPath::STRATUM_PATH) continue;
+  for (int i : pathIndices(lev, IgnitionPath::STRATUM_PATH)) {
+    const IgnitionPath& ip = paths_[i];
     returnValue += ip.basicROS()*ip.species().composition();
   }
   return returnValue;
@@ -154,8 +165,9 @@ double ForestIgnitionRun::speciesWeightedBasicROS(const Stratum::LevelType& lev)
 double ForestIgnitionRun::speciesWeightedIgnitionTimeStep(const Stratum::LevelType& lev,
                 const IgnitionPath::PathType ptype) const {
   double returnValue = 0;
-  for (const IgnitionPath& ip : paths_) {
-    if (!ip.hasSegments() || ip.level() != lev || ip.type() != ptype) continue;
+  for (int i : pathIndices(lev, ptype)) {
+    const IgnitionPath& ip = paths_[i];
+    if (!ip.hasSegments()) continue;
     returnValue += ip.species().composition()*ip.startTimeStep();
   }
   return returnValue;
@@ -171,8 +183,9 @@ double ForestIgnitionRun::speciesWeightedIgnitionTimeStep(const Stratum::LevelTy
 double ForestIgnitionRun::speciesWeightedTimeStepsIgnitionToMaxFlame(const Stratum::LevelType& lev,
                const IgnitionPath::PathType ptype) const {
   double returnValue = 0;
-  for (const IgnitionPath& ip : paths_) {
-    if (!ip.hasSegments() || ip.level() != lev || ip.type() != ptype) continue;
+  for (int i : pathIndices(lev, ptype)) {
+    const IgnitionPath& ip = paths_[i];
+    if (!ip.hasSegments()) continue;
     returnValue += ip.species().composition()*ip.timeStepsIgnitionToMaxFlame();
   }
   return returnValue;
@@ -201,22 +214,20 @@ double ForestIgnitionRun::activeCrownFireROS(const Results& res) const {
               IgnitionPath::PLANT_PATH)));
 
       Pt weightedFlameOrigin(0,0);
-      for (const Species& sp : st.allSpecies()) {
+      const std::vector<Species>& allSpecies = st.allSpecies();
+      const std::vector<int>& speciesIds = forest_.speciesIds(st.level());
+      for (unsigned k = 0; k < allSpecies.size(); ++k) {
+        const Species& sp = allSpecies[k];
+        int id = speciesIds[k];
         //find the stratum ignition path for this species
-        auto i = find_if(paths_.begin(), paths_.end(),
-            [sp,st](IgnitionPath ip){return ip.species().sameSpecies(sp) && 
-            ip.level() == st.level() &&
-            ip.type() == IgnitionPath::STRATUM_PATH;});
+        auto i = findPath(st.level(), IgnitionPath::STRATUM_PATH, id);
 
         if (i < paths_.end())
           //there is a stratum path for this species
           weightedFlameOrigin += (*i).origin(std::min((*i).numSegments() - 1, nextIgnitTimeStep - 1)) * sp.composition();
         else {
           //there was no stratum path for this species, we'll use the last origin from the plant path
-          i = find_if(paths_.begin(), paths_.end(), 
-              [sp,st](IgnitionPath ip){return ip.species().sameSpecies(sp) && 
-              ip.level() == st.level() &&
-              ip.type() == IgnitionPath::PLANT_PATH;});
+          i = findPath(st.level(), IgnitionPath::PLANT_PATH, id);
           if (i < paths_.end())
             weightedFlameOrigin += (*i).origin() * sp.composition();
         }
@@ -249,20 +260,18 @@ double ForestIgnitionRun::activeCrownFireROS(const Results& res) const {
   } //end of loop over strata
 
   //add the species weighted distance travelled in the Canopy
-  for (const Species& sp : forest_.stratum(Stratum::CANOPY).allSpecies()) {
-    auto i = find_if(paths_.begin(), paths_.end(),
-        [sp](IgnitionPath ip){return ip.level() == Stratum::CANOPY &&
-        ip.species().sameSpecies(sp) &&
-        ip.type() == IgnitionPath::STRATUM_PATH;});
+  const std::vector<Species>& canopySpecies = forest_.stratum(Stratum::CANOPY).allSpecies();
+  const std::vector<int>& canopySpeciesIds = forest_.speciesIds(Stratum::CANOPY);
+  for (unsigned k = 0; k < canopySpecies.size(); ++k) {
+    const Species& sp = canopySpecies[k];
+    int id = canopySpeciesIds[k];
+    auto i = findPath(Stratum::CANOPY, IgnitionPath::STRATUM_PATH, id);
 
     if (i < paths_.end())
       horizontalDistanceSum += ((*i).maxX() + sp.width()*0.5)*sp.composition();
     else {
       //did not find a stratum path for this species, look for the plant path
-      i = find_if(paths_.begin(), paths_.end(),
-          [sp](IgnitionPath ip){return ip.level() == Stratum::CANOPY &&
-          ip.species().sameSpecies(sp) &&
-          ip.type() == IgnitionPath::PLANT_PATH;});
+      i = findPath(Stratum::CANOPY, IgnitionPath::PLANT_PATH, id);
       if (i < paths_.end())
         horizontalDistanceSum += ((*i).maxX() + sp.width()*0.5)*sp.composition();
     }
@@ -288,8 +297,9 @@ double ForestIgnitionRun::activeCrownFireROS(const Results& res) const {
 Pt ForestIgnitionRun::speciesWeightedOriginOfMaxFlame(const Stratum::LevelType& lev, 
                   const IgnitionPath::PathType& ptype) const {
   Pt returnValue(0,0);
-  for (const IgnitionPath ip : paths_) {
-    if (!ip.hasSegments() || ip.level() != lev || ip.type() != ptype)
+  for (int i : pathIndices(lev, ptype)) {
+    const IgnitionPath& ip = paths_[i];
+    if (!ip.hasSegments())
       continue;
     returnValue += ip.species().composition()*ip.originOfMaxSegment();
   }
@@ -305,17 +315,22 @@ double ForestIgnitionRun::speciesWeightedMaxHeightBurnt(const Stratum::LevelType
   if (paths_.empty()) return 0;
   double returnValue = 0; 
   //loop over the species
-  for (const Species& spec : forest_.stratum(lev).allSpecies()){
+  const std::vector<Species>& allSpecies = forest_.stratum(lev).allSpecies();
+  const std::vector<int>& speciesIds = forest_.speciesIds(lev);
+  for (unsigned k = 0; k < allSpecies.size(); ++k){
+    const Species& spec = allSpecies[k];
+    int id = speciesIds[k];
     double tmp = 0;
-    auto i = find_if(paths_.begin(), paths_.end(),
-         [spec](IgnitionPath ip){return ip.species().sameSpecies(spec) && 
-               ip.type() == IgnitionPath::STRATUM_PATH;});
+    //the first path of each type for this species, at any level
+    auto i = paths_.end(), j = paths_.end();
+    for (int l = Stratum::SURFACE; l < NUM_LEVELS; ++l) {
+      Stratum::LevelType pathLev = static_cast<Stratum::LevelType>(l);
+      if (i == paths_.end()) i = findPath(pathLev, IgnitionPath::STRATUM_PATH, id);
+      if (j == paths_.end()) j = findPath(pathLev, IgnitionPath::PLANT_PATH, id);
+    }
     if (i != paths_.end())
       tmp = (*i).maxHeightBurnt(forest_.surface().slope());
 
-    auto j = find_if(paths_.begin(), paths_.end(),
-         [spec](IgnitionPath ip){return ip.species().sameSpecies(spec) &&
-               ip.type() == IgnitionPath::PLANT_PATH;});
     if (j != paths_.end()){
       tmp = std::max(tmp, (*j).maxHeightBurnt(forest_.surface().slope()));
     }
@@ -338,4 +353,16 @@ std::string ForestIgnitionRun::printToString() const {
   return str;
 }
 
-
+/*!\brief Printing of the counters
+  \return A table of the counts of the ignition path computations of each stratum with any,
+  and of the run
+*/
+std::string ForestIgnitionRun::printCountersToString() const {
+  std::string str = "Run type:                 " + runTypeStringMap.at(type_) + "\n";
+  str += IgnitionCounters::printHeader();
+  for (int l = Stratum::SURFACE; l < NUM_LEVELS; ++l)
+    if (counters_[l].calls > 0)
+      str += counters_[l].printToString(levelStringMap.at(static_cast<Stratum::LevelType>(l)));
+  str += counters().printToString("Total");
+  return str;
+}
@@ -1,13 +1,16 @@
 #ifndef FOREST_IGNITION_RUN_H
 #define FOREST_IGNITION_RUN_H
 
+#include <array>
 #include <vector>
 #include <map>
+#include <tuple>
 
 #include "stratum.h"
 #include "forest.h"
 #include "flame.h"
 #include "ignition_path.h"
+#include "flame_length_table.h"
 //#include "results.h"
 
 class Results;
@@ -31,12 +34,6 @@ public:
   */
   enum RunType{UNKNOWN_RUN_TYPE, WITH_CANOPY, WITHOUT_CANOPY};
 
-  /*
-   * String used as key to identify weighted average flame lengths in map returned
-   * by speciesWeightedFlameLengths and laterallyMergedSpeciesWeightedPlantFlameLengths.
-   */
-  const static std::string KEY_WEIGHTED_AVERAGE;
-
   //constructors
 
   ForestIgnitionRun();
@@ -47,27 +44,37 @@ public:
 
   Forest forest() const;
   RunType type() const;
-  std::vector<IgnitionPath> paths() const;
+  const std::vector<IgnitionPath>& paths() const;
   std::vector<Flame> combinedFlames() const;
+  const IgnitionCounters& counters(const Stratum::LevelType& level) const;
+  IgnitionCounters counters() const;
 
   //mutators
   void type(const RunType& runType);
   void addPath(const IgnitionPath& ignitionPath);
   void combinedFlames(const std::vector<Flame>& flames);
+  void addCounters(const Stratum::LevelType& level, const IgnitionCounters& counters);
 
   //other methods
   bool spreadsInStratum(const Stratum::LevelType& level) const;
   
-  std::map<std::string, std::vector<double>> speciesWeightedFlameLengths(const Stratum::LevelType& level, 
-						  const IgnitionPath::PathType& ptype) const;
+  void speciesWeightedFlameLengths(const Stratum::LevelType& level, 
+				   const IgnitionPath::PathType& ptype,
+				   FlameLengthTable& table) const;
   
-  std::map<std::string, std::vector<double>> laterallyMergedSpeciesWeightedPlantFlameLengths(const Stratum::LevelType& level, 
-								 const double& firelineLength) const;
+  void laterallyMergedSpeciesWeightedPlantFlameLengths(const Stratum::LevelType& level, 
+						       const double& firelineLength,
+						       FlameLengthTable& table) const;
   
   double highestFlameOriginY(const Stratum::LevelType& level, const IgnitionPath::PathType& ptype) const;
 
   std::vector<IgnitionPath>::const_iterator beginPaths() const;
   std::vector<IgnitionPath>::const_iterator endPaths() const;
+  std::vector<IgnitionPath>::const_iterator findPath(const Stratum::LevelType& level, 
+						     const IgnitionPath::PathType& ptype,
+						     const int& speciesId) const;
+  const std::vector<int>& pathIndices(const Stratum::LevelType& level, 
+				      const IgnitionPath::PathType& ptype) const;
   std::vector<Flame>::const_iterator beginCombinedFlames() const;
   std::vector<Flame>::const_iterator endCombinedFlames() const;
   double speciesWeightedBasicROS(const Stratum::LevelType& level) const;
@@ -80,12 +87,31 @@ public:
   Pt speciesWeightedOriginOfMaxFlame(const Stratum::LevelType& level, 
 				     const IgnitionPath::PathType& pathType) const;
   std::string printToString() const;
+  std::string printCountersToString() const;
 
 private:
   RunType type_ = UNKNOWN_RUN_TYPE;
   Forest forest_ = Forest();
   std::vector<IgnitionPath> paths_ = std::vector<IgnitionPath>();
   std::vector<Flame> combinedFlames_ = std::vector<Flame>();
+
+  //number of distinct values of Stratum::LevelType and IgnitionPath::PathType, excluding unknowns
+  static const int NUM_LEVELS = Stratum::CANOPY + 1;
+  static const int NUM_PATH_TYPES = IgnitionPath::STRATUM_PATH + 1;
+
+  //a path is identified by its level, type and species identifier
+  typedef std::tuple<Stratum::LevelType, IgnitionPath::PathType, int> PathKey;
+
+  //positions in paths_ by level and path type, and of the first path with each key,
+  //updated by indexPath() whenever a path is added
+  std::array<std::array<std::vector<int>, NUM_PATH_TYPES>, NUM_LEVELS> pathIndices_;
+  std::map<PathKey, int> pathIndex_;
+
+  //work done by every computeIgnitionPath call made for the run, including the ignition
+  //point scenarios whose paths were not kept, by level
+  std::array<IgnitionCounters, NUM_LEVELS> counters_ = {};
+
+  void indexPath(const int& i);
 };
 
 //map for printing
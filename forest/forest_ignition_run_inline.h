@@ -41,13 +41,30 @@ inline Forest ForestIgnitionRun::forest() const {return forest_;}
 /*!\brief All the ignition paths
   \return The vector of IgnitionPath objects.
 */
-inline std::vector<IgnitionPath> ForestIgnitionRun::paths() const {return paths_;}
+inline const std::vector<IgnitionPath>& ForestIgnitionRun::paths() const {return paths_;}
 
 /*!\brief The combined flames
   \return The vector (time series) of combined flames from the surface and all strata.
 */
 inline std::vector<Flame> ForestIgnitionRun::combinedFlames() const {return combinedFlames_;}
 
+/*!\brief Counts of the ignition path computations in a stratum
+  \param level
+  \return The counts summed over every path computed at level, zero unless built with FFM_COUNTERS
+*/
+inline const IgnitionCounters& ForestIgnitionRun::counters(const Stratum::LevelType& level) const {
+  return counters_.at(level);
+}
+
+/*!\brief Counts of the ignition path computations of the run
+  \return The counts summed over all levels
+*/
+inline IgnitionCounters ForestIgnitionRun::counters() const {
+  IgnitionCounters total;
+  for (const IgnitionCounters& c : counters_) total.add(c);
+  return total;
+}
+
 //mutators
 
 /*!\brief Set the run type
@@ -63,15 +80,26 @@ inline void ForestIgnitionRun::type(const RunType& run_type) {
   \param ip The ignition path to be added
 
 
-  Adds an IgnitionPath object to the vector of all ignition paths
+  Adds an IgnitionPath object to the vector of all ignition paths, which is kept
+  ordered by level. The new path goes after any existing paths at the same level.
 */
 inline void ForestIgnitionRun::addPath(const IgnitionPath& ip) {
-  paths_.push_back(ip);
-  std::sort(paths_.begin(), paths_.end(), 
-	    [](IgnitionPath p1, IgnitionPath p2) {
-	      return p1.level() < p2.level();});
+  auto pos = std::upper_bound(paths_.begin(), paths_.end(), ip,
+			      [](const IgnitionPath& p1, const IgnitionPath& p2) {
+				return p1.level() < p2.level();});
+  int i = pos - paths_.begin();
+  paths_.insert(pos, ip);
+  indexPath(i);
 }
   
+/*!\brief Adds the counts of an ignition path computation
+  \param level The level of the path
+  \param counters
+*/
+inline void ForestIgnitionRun::addCounters(const Stratum::LevelType& level, const IgnitionCounters& counters) {
+  counters_.at(level).add(counters);
+}
+
 /*!\brief Set the combined flames
   \param flames 
 
@@ -100,6 +128,35 @@ inline std::vector<IgnitionPath>::const_iterator ForestIgnitionRun::endPaths() c
   return paths_.cend();
 }
 
+/*!\brief Find an ignition path
+  \param lev
+  \param ptype
+  \param speciesId The Forest::speciesRegistry() identifier of the species
+  \return A constant iterator pointing to the first IgnitionPath with Stratum::LevelType 
+  equal to lev, IgnitionPath::PathType equal to ptype and species identifier equal to 
+  speciesId, or endPaths() if there is no such path.
+*/
+inline std::vector<IgnitionPath>::const_iterator ForestIgnitionRun::findPath(const Stratum::LevelType& lev, 
+									   const IgnitionPath::PathType& ptype,
+									   const int& speciesId) const {
+  auto i = pathIndex_.find(PathKey(lev, ptype, speciesId));
+  return i == pathIndex_.end() ? paths_.cend() : paths_.cbegin() + i->second;
+}
+
+/*!\brief Positions of the ignition paths of a level and type
+  \param lev
+  \param ptype
+  \return The positions in paths(), in increasing order, of the IgnitionPath objects with 
+  Stratum::LevelType equal to lev and IgnitionPath::PathType equal to ptype.
+*/
+inline const std::vector<int>& ForestIgnitionRun::pathIndices(const Stratum::LevelType& lev, 
+							      const IgnitionPath::PathType& ptype) const {
+  static const std::vector<int> noIndices;
+  if (lev < Stratum::SURFACE || lev >= NUM_LEVELS || ptype < 0 || ptype >= NUM_PATH_TYPES)
+    return noIndices;
+  return pathIndices_[lev][ptype];
+}
+
 /*!\brief Iterator
   \return A constant iterator pointing to the beginning of the vector of 
   combined flames.
@@ -8,7 +8,9 @@
 
 /*!\brief Default constructor produces empty forest
  */
-inline Forest::Forest() : surface_(), strata_() , strataOverlaps_() {}
+inline Forest::Forest() : surface_(), strata_() , strataOverlaps_() {
+  indexStrata();
+}
 //accessors
 
 /*!\brief The Surface
@@ -19,15 +21,124 @@ inline Surface Forest::surface() const {return surface_;}
 /*!\brief The strata of the Forest
   \return The vector of Stratum objects associated with the Forest.
 */
-inline std::vector<Stratum> Forest::strata() const {return strata_;}
+inline const std::vector<Stratum>& Forest::strata() const {return strata_;}
 
 /*!\brief Overlap information
   \return A vector of type Forest::StrataOverlap containing the overlap information.
 */ 
 inline std::vector<Forest::StrataOverlap> Forest::strataOverlaps() const {return strataOverlaps_;}
 
+/*!\brief Species identifiers
+  \return The SpeciesRegistry holding the identifiers of the species in the Forest.
+*/
+inline const SpeciesRegistry& Forest::speciesRegistry() const {return speciesRegistry_;}
+
+//mutators
+
+/*!\brief Replaces the Surface
+  \param surface
+
+  The strata are unaffected, so a Forest can be reused for a range of surface conditions. 
+  Note that the dead fuel moisture content of the Surface is not passed on to the species, 
+  for which deadLeafMoisture() is used.
+*/
+inline void Forest::surface(const Surface& surface) {surface_ = surface;}
+
 //other methods
 
+/*!\brief Tests whether a level can be used to index the lookup tables
+  \param lev
+  \return true if and only if lev is not Stratum::UNKNOWN_LEVEL.
+*/
+inline bool Forest::validLevel(const Stratum::LevelType& lev) {
+  return lev >= Stratum::SURFACE && lev < NUM_LEVELS;
+}
+
+/*!\brief Tests for the existence of a prescribed Stratum::LevelType in the Forest
+  \param lev 
+  \return true if and only if the Forest contains a Stratum with Stratum::LevelType equal to lev.
+*/
+inline bool Forest::hasLevel(const Stratum::LevelType& lev) const {
+  return validLevel(lev) && levelIndex_[lev] >= 0;
+}
+
+/*!\brief Extracts the Stratum at a prescribed Stratum::LevelType
+  \param lev The Stratum::LevelType of the Stratum that is required
+  \return The Stratum object corresponding to level. 
+
+  If lev is not contained in the Forest then returns default empty stratum.
+*/
+inline const Stratum& Forest::stratum(const Stratum::LevelType& lev) const {
+  static const Stratum emptyStratum;
+  return hasLevel(lev) ? strata_[levelIndex_[lev]] : emptyStratum;
+}
+
+/*!\brief Identifiers of the species at a prescribed Stratum::LevelType
+  \param lev
+  \return The speciesRegistry() identifiers of the species of the Stratum at lev, in the 
+  same order as Stratum::allSpecies(). Empty if lev is not contained in the Forest.
+*/
+inline const std::vector<int>& Forest::speciesIds(const Stratum::LevelType& lev) const {
+  static const std::vector<int> noIds;
+  return hasLevel(lev) ? speciesIds_[lev] : noIds;
+}
+
+/*!\brief Shared copies of the species at a prescribed Stratum::LevelType
+  \param lev
+  \return Pointers to copies of the species of the Stratum at lev, in the same order 
+  as Stratum::allSpecies(). Empty if lev is not contained in the Forest.
+
+  These allow an IgnitionPath to refer to its Species without copying it.
+*/
+inline const std::vector<std::shared_ptr<const Species>>& 
+Forest::speciesHandles(const Stratum::LevelType& lev) const {
+  static const std::vector<std::shared_ptr<const Species>> noHandles;
+  return hasLevel(lev) ? speciesHandles_[lev] : noHandles;
+}
+
+/*!\brief The level of the next Stratum above thisLevel
+  \param  thisLevel The Stratum::LevelType of the Stratum in question
+  \return The next highest Stratum::LevelType of the Forest
+
+  If thisLevel does not exist 
+  in the forest, or is the highest level then returns Stratum::UNKNOWN_LEVEL
+*/
+inline Stratum::LevelType Forest::nextLevel(const Stratum::LevelType& thisLevel) const {
+  return hasLevel(thisLevel) ? nextLevel_[thisLevel] : Stratum::UNKNOWN_LEVEL;
+}
+
+/*!\brief Find the Forest::StrataOverlapType associated with level1 and level2.
+  \param level1
+  \param level2
+  \return If strataOverlaps() returns a Forest::StrataOverlap associated with level1 and level2 then
+  the associated Forest::StrataOverlapType is returned. Returns Forest::AUTO_CALC_OVERLAP if there is 
+  no Forest::StrataOverlap associated with level1 and level2. 
+
+  Order of level1 and level2 is not important. The value is looked up in a table built 
+  when the Forest is constructed.
+*/
+inline Forest::StrataOverlapType Forest::strataOverlap(const Stratum::LevelType& level1, 
+						       const Stratum::LevelType& level2) const {
+  if (!validLevel(level1) || !validLevel(level2)) return AUTO_CALC_OVERLAP;
+  return overlap_[level1][level2];
+}
+
+/*!\brief Determines whether the Stratum at level1 can exist under the Stratum at level2
+  \param level1
+  \param level2
+  \return true if and only if the Stratum at the lower of level1 and level2 can exist
+  under the Stratum at the higher of level1 and level2.
+
+  The order of level1 and level2 is not important. The value is looked up in a table 
+  built when the Forest is constructed, see computeVerticalAssociation().
+*/
+inline bool Forest::verticalAssociation(const Stratum::LevelType& level1, 
+					const Stratum::LevelType& level2) const {
+  if (!validLevel(level1) || !validLevel(level2)) 
+    return computeVerticalAssociation(level1, level2);
+  return verticalAssociation_[level1][level2];
+}
+
 /*!\brief Tests to see if the Forest contains any strata
   \return true if and only if the vector of strata is empty.
 */
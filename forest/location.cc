@@ -12,13 +12,15 @@
 #include "flame_series.h"
 #include "ffm_settings.h"
 #include "ffm_util.h"
+#include "ffm_trace.h"
+#include "ffm_alloc.h"
 #include "pre_heating_flame.h"
 #include "stratum_results.h"
 #include "forest_ignition_run.h"
 
-bool DUMP_FLAME_LENGTHS_TO_CONSOLE = false;
+const bool DUMP_FLAME_LENGTHS_TO_CONSOLE = false;
 
-void dumpFlameLengths(std::map<std::string, std::vector<double>> flameLengths, std::string header) {
+void dumpFlameLengths(const FlameLengthTable& flameLengths, std::string header) {
   using namespace std;
 
   if (DUMP_FLAME_LENGTHS_TO_CONSOLE) {
@@ -26,16 +28,17 @@ void dumpFlameLengths(std::map<std::string, std::vector<double>> flameLengths, s
     cout.setf(ios::fixed|ios::showpoint);
     cout << setprecision(2);
 
-    for ( map<string, vector<double>>::iterator it = flameLengths.begin();
-        it != flameLengths.end(); ++it) {
+    for (int row = 0; row <= flameLengths.numRows(); ++row) {
+      //the weighted average follows the species rows
+      bool average = row == flameLengths.numRows();
+      if (!average && !flameLengths.filled(row)) continue;
 
-      string name = it->first;
-      vector<double>& flens = it->second;
+      const vector<double>& flens = average ? flameLengths.weightedAverage() : flameLengths.flameLengths(row);
 
-      cout << name << ":";
+      cout << (average ? "WEIGHTED_AVERAGE" : flameLengths.name(row)) << ":";
 
-      for ( vector<double>::iterator vit = flens.begin(); vit != flens.end(); ++vit) 
-        if (*vit > 0) cout << *vit << ' ';
+      for (const double& fl : flens) 
+        if (fl > 0) cout << fl << ' ';
 
       cout << endl;
     }
@@ -48,31 +51,48 @@ void dumpFlameLengths(std::map<std::string, std::vector<double>> flameLengths, s
 
 
 /*!\brief Main computation
+  \param outputLevel The outputs that will be used. Results::BASIC assembles only the 
+  overall outputs and the stratum outputs they depend on, Results::MONTE_CARLO adds the
+  detailed overall outputs (the Monte Carlo columns), Results::DETAILED adds the species 
+  flame tip heights and proportions of strata burnt, and Results::COMPREHENSIVE also 
+  keeps the ForestIgnitionRun objects, with the pre-ignition data of their paths.
   \return A Results object after performing the forest fire computations.
+
+  The ignition runs are always computed in full, since every output depends on them.
 */
-Results Location::results() const {
+Results Location::results(const Results::OutputLevelType& outputLevel) const {
   
+  ffm_trace::Span span("Location::results");
+
+  const bool detailed = outputLevel != Results::BASIC;
+  const bool stratumDetail = outputLevel == Results::DETAILED || outputLevel == Results::COMPREHENSIVE;
+  const bool keepRuns = outputLevel == Results::COMPREHENSIVE;
+
   Results overallResults; 
 
   //do the ignition computation
 
   //with canopy
-  ForestIgnitionRun fir1 = forestIgnitionRun(true);
-  overallResults.addRun(fir1);
+  ffm_alloc::Phase runPhase("ignition run with canopy");
+  ForestIgnitionRun fir1 = forestIgnitionRun(true, keepRuns);
+  runPhase.end();
 
   ForestIgnitionRun fir2;
   bool runTwoExists = false;
   //if there is spread in the canopy do it with windfield computed using no canopy
   if (fir1.spreadsInStratum(Stratum::CANOPY)){
-    fir2 = forestIgnitionRun(false);
-    overallResults.addRun(fir2);
+    ffm_alloc::Phase runTwoPhase("ignition run without canopy");
+    fir2 = forestIgnitionRun(false, keepRuns);
     runTwoExists = true;
   }
+  overallResults.runTwoExists(runTwoExists);
   //fir is a reference to the second run if it was done, else the first run
   const ForestIgnitionRun& fir = runTwoExists ? fir2 : fir1;
 
   //****************** surface results **************************************
 
+  ffm_alloc::Phase assemblyPhase("results assembly");
+  ffm_trace::Span surfaceSpan("surface results");
   double sws = forest_.windProfile(incidentWindSpeed_, 
                                    forest_.heightForSurfaceWind(), 
                                    !runTwoExists);
@@ -82,11 +102,16 @@ Results Location::results() const {
   double sfa = flameAngle(sfl, sws, slope(), firelineLength_);
   overallResults.surfaceFlameAngle(sfa);
   overallResults.surfaceFlameHeight(sfl*sin(sfa) - sfl*cos(sfa)*tan(slope()));
+  surfaceSpan.end();
 
   //****************** stratum results **************************************
 
+  //flame length tables, reused for each stratum
+  FlameLengthTable plantFlameLengths, stratumFlameLengths, selectedFlameLengths;
+
   for (const Stratum& strat : forest_.strata()) {
     
+    ffm_trace::Span stratumSpan("stratum results", levelStringMap.at(strat.level()));
     StratumResults stratResults(strat.level());
 
     //*************** stratum flame lengths *********************************
@@ -95,7 +120,6 @@ Results Location::results() const {
     //compute flame heights
 
     double flameLength;
-    std::map<std::string, std::vector<double>> selectedFlameLengths;
 
     // origin of longest flame to use as representative origin for stratum
     // flame height calculations
@@ -107,17 +131,14 @@ Results Location::results() const {
     double maxOriginHeight;  
 
     if (strat.level() != Stratum::CANOPY) {
-      std::map<std::string, std::vector<double>> plantFlameLengths = 
-        fir.laterallyMergedSpeciesWeightedPlantFlameLengths(strat.level(), firelineLength_);
-
-      std::map<std::string, std::vector<double>> stratumFlameLengths = 
-        fir.speciesWeightedFlameLengths(strat.level(), IgnitionPath::STRATUM_PATH);
+      fir.laterallyMergedSpeciesWeightedPlantFlameLengths(strat.level(), firelineLength_, plantFlameLengths);
+      fir.speciesWeightedFlameLengths(strat.level(), IgnitionPath::STRATUM_PATH, stratumFlameLengths);
 
-      double plantFlameLength = ffm_util::cappedMax( plantFlameLengths.at( ForestIgnitionRun::KEY_WEIGHTED_AVERAGE ) );
+      double plantFlameLength = ffm_util::cappedMax( plantFlameLengths.weightedAverage() );
       double stratumFlameLength = 0.0;
 
       if (ffm_numerics::gtZero(plantFlameLength)) {
-        stratumFlameLength = ffm_util::cappedMax( stratumFlameLengths.at( ForestIgnitionRun::KEY_WEIGHTED_AVERAGE ) );
+        stratumFlameLength = ffm_util::cappedMax( stratumFlameLengths.weightedAverage() );
 
         if (plantFlameLength > stratumFlameLength){
           flameLength = plantFlameLength;
@@ -139,17 +160,14 @@ Results Location::results() const {
       }
 
     } else { //the canopy
-      std::map<std::string, std::vector<double>> plantFlameLengths = 
-        fir1.laterallyMergedSpeciesWeightedPlantFlameLengths(strat.level(), firelineLength_);
+      fir1.laterallyMergedSpeciesWeightedPlantFlameLengths(strat.level(), firelineLength_, plantFlameLengths);
+      fir1.speciesWeightedFlameLengths(strat.level(), IgnitionPath::STRATUM_PATH, stratumFlameLengths);
 
-      std::map<std::string, std::vector<double>> stratumFlameLengths = 
-        fir1.speciesWeightedFlameLengths(strat.level(), IgnitionPath::STRATUM_PATH);
-
-      double plantFlameLength = ffm_util::cappedMax( plantFlameLengths.at( ForestIgnitionRun::KEY_WEIGHTED_AVERAGE ) );
+      double plantFlameLength = ffm_util::cappedMax( plantFlameLengths.weightedAverage() );
       double stratumFlameLength = 0.0;
 
       if (ffm_numerics::gtZero(plantFlameLength)) {
-        stratumFlameLength = ffm_util::cappedMax( stratumFlameLengths.at( ForestIgnitionRun::KEY_WEIGHTED_AVERAGE ) );
+        stratumFlameLength = ffm_util::cappedMax( stratumFlameLengths.weightedAverage() );
 
         if (plantFlameLength > stratumFlameLength){
           flameLength = plantFlameLength;
@@ -171,16 +189,13 @@ Results Location::results() const {
       }
       
       if (runTwoExists) {
-        plantFlameLengths = 
-          fir2.laterallyMergedSpeciesWeightedPlantFlameLengths(strat.level(), firelineLength_);
-
-        stratumFlameLengths = 
-          fir2.speciesWeightedFlameLengths(strat.level(), IgnitionPath::STRATUM_PATH);
+        fir2.laterallyMergedSpeciesWeightedPlantFlameLengths(strat.level(), firelineLength_, plantFlameLengths);
+        fir2.speciesWeightedFlameLengths(strat.level(), IgnitionPath::STRATUM_PATH, stratumFlameLengths);
 
-        plantFlameLength = ffm_util::cappedMax( plantFlameLengths.at( ForestIgnitionRun::KEY_WEIGHTED_AVERAGE ) );
+        plantFlameLength = ffm_util::cappedMax( plantFlameLengths.weightedAverage() );
 
         if (ffm_numerics::gtZero(plantFlameLength)) {
-          stratumFlameLength = ffm_util::cappedMax( stratumFlameLengths.at( ForestIgnitionRun::KEY_WEIGHTED_AVERAGE ) );
+          stratumFlameLength = ffm_util::cappedMax( stratumFlameLengths.weightedAverage() );
 
           if(stratumFlameLength > flameLength) {
             flameLength = stratumFlameLength;
@@ -230,34 +245,38 @@ Results Location::results() const {
     stratResults.flameTipHeight(ht);
     stratResults.flameOriginHeight(maxOriginHeight);
 
-    // Representative flame heights for contributing species flames
-    for (const Species& spec : strat.allSpecies()) {
-      std::map<std::string, std::vector<double>>::iterator it = selectedFlameLengths.find(spec.name());
-      if (it != selectedFlameLengths.end()) {  // ie. species has an entry
-        double maxLen = ffm_util::cappedMax( it->second );  
+    // Representative flame heights for contributing species flames, only reported in detail
+    if (stratumDetail) {
+      for (unsigned k = 0; k < strat.allSpecies().size(); ++k) {
+        const Species& spec = strat.allSpecies()[k];
+        int row = selectedFlameLengths.row(k);
+        if (row >= 0 && selectedFlameLengths.filled(row)) {  // ie. species has an entry
+          double maxLen = ffm_util::cappedMax( selectedFlameLengths.flameLengths(row) );  
         
-        ht = longestFlameOrigin.y() + maxLen * sin(flameAng) - 
-          (longestFlameOrigin.x() + maxLen * cos(flameAng)) * tan(slope());
-      }
-      else {  // no entry for species - must not even have pre-ignition data
-        ht = 0.0;
-      }
+          ht = longestFlameOrigin.y() + maxLen * sin(flameAng) - 
+            (longestFlameOrigin.x() + maxLen * cos(flameAng)) * tan(slope());
+        }
+        else {  // no entry for species - must not even have pre-ignition data
+          ht = 0.0;
+        }
 
-      stratResults.addSpeciesFlameTipHeight(spec.name(), ht);
+        stratResults.addSpeciesFlameTipHeight(spec.name(), ht);
+      }
     }
-    
+
     //*********** stratum rate of spread ************************
     
     double stratROS = 0;
 
     if (strat.level() == Stratum::NEAR_SURFACE) {
-      for (const Species& spec : strat.allSpecies()) {
+      const std::vector<Species>& allSpecies = strat.allSpecies();
+      const std::vector<int>& speciesIds = forest_.speciesIds(strat.level());
+      for (unsigned k = 0; k < allSpecies.size(); ++k) {
+        const Species& spec = allSpecies[k];
+        int id = speciesIds[k];
         double specROS = 0;
         //find the plant path if it exists
-        auto i = find_if(fir.beginPaths(), fir.endPaths(), 
-                         [spec,strat](IgnitionPath ip){return ip.species().sameSpecies(spec) &&
-                                                       ip.level() == strat.level() &&
-                                                       ip.type() == IgnitionPath::PLANT_PATH;});
+        auto i = fir.findPath(strat.level(), IgnitionPath::PLANT_PATH, id);
         if (i < fir.endPaths()) {
           //weighted sum of plant and surface ros
           double tmp = std::min(1.0,(*i).species().width()/strat.modelPlantSep());
@@ -265,10 +284,7 @@ Results Location::results() const {
         }
         if (fir.spreadsInStratum(strat.level())) {
           //find the stratum path if it exists
-          i = find_if(fir.beginPaths(), fir.endPaths(), 
-                      [strat,spec](IgnitionPath ip){return ip.species().sameSpecies(spec) &&
-                                                    ip.level() == strat.level() &&
-                                                    ip.type() == IgnitionPath::STRATUM_PATH;});
+          i = fir.findPath(strat.level(), IgnitionPath::STRATUM_PATH, id);
           if (i < fir.endPaths())
             //species ROS is the max of those of the plant and stratum
             specROS = std::max(specROS, (*i).basicROS());
@@ -291,9 +307,8 @@ Results Location::results() const {
         if (stratResults.flameAngle() <= slope() + ffm_settings::independentSpreadSensitivity) {
           //check species-weighted sum of average ros in last two time steps of stratum fire
           double specWeightedSum = 0;
-          for (const IgnitionPath& ip : fir.paths()){
-            if (ip.type() != IgnitionPath::STRATUM_PATH || ip.level() != strat.level())
-              continue;
+          for (int i : fir.pathIndices(strat.level(), IgnitionPath::STRATUM_PATH)){
+            const IgnitionPath& ip = fir.paths()[i];
             if (ip.fullSize())
               specWeightedSum += 0.5*(ip.ros(ip.numSegments() - 1) + ip.ros(ip.numSegments() - 2))*ip.species().composition();
           }
@@ -306,9 +321,8 @@ Results Location::results() const {
           //computed species weighted max distance travelled in stratum, and species 
           //weighted time
           double distance = 0, time = 0;
-          for (const IgnitionPath& ip : fir.paths()) {
-            if (ip.type() != IgnitionPath::STRATUM_PATH || ip.level() != strat.level())
-              continue;
+          for (int i : fir.pathIndices(strat.level(), IgnitionPath::STRATUM_PATH)) {
+            const IgnitionPath& ip = fir.paths()[i];
             if (ip.spreads()){
               distance += ip.maxHorizontalRun()*ip.species().composition();
               time += (ip.startTimeStep() + ip.numSegments())*ffm_settings::computationTimeInterval*
@@ -343,12 +357,14 @@ Results Location::results() const {
 
     //********************* Stratum proportion burnt *************************************
 
-    double maxHeight = fir1.speciesWeightedMaxHeightBurnt(strat.level());
-    if (runTwoExists)
-      maxHeight = std::max(maxHeight, fir2.speciesWeightedMaxHeightBurnt(strat.level()));
-    double propBurnt = (maxHeight - strat.avBottom()) / (strat.avTop() - strat.avBottom());
-    propBurnt = std::min(1.0,std::max(0.0,propBurnt));
-    stratResults.proportionBurnt(propBurnt);
+    if (stratumDetail) {
+      double maxHeight = fir1.speciesWeightedMaxHeightBurnt(strat.level());
+      if (runTwoExists)
+        maxHeight = std::max(maxHeight, fir2.speciesWeightedMaxHeightBurnt(strat.level()));
+      double propBurnt = (maxHeight - strat.avBottom()) / (strat.avTop() - strat.avBottom());
+      propBurnt = std::min(1.0,std::max(0.0,propBurnt));
+      stratResults.proportionBurnt(propBurnt);
+    }
 
     overallResults.addStratumResults(stratResults);
 
@@ -368,16 +384,6 @@ Results Location::results() const {
     overallResults.ros(std::max((*i).ros(), overallResults.surfaceROS()));
   }
 
-  //****************** Wind reduction factor *******************************************
-
-  //computed with canopy on
-  
-  if (incidentWindSpeed_ <= 0)
-    overallResults.windReductionFactor(1);
-  else
-    overallResults.windReductionFactor(incidentWindSpeed_ / 
-                                       forest_.windProfile(incidentWindSpeed_, 1.5, true));
-
   //*********************** Overall flame angle ****************************************
 
   //flame length weighted sum of all the strata flame angles
@@ -412,7 +418,7 @@ Results Location::results() const {
   double maxTip = overallResults.surfaceFlameHeight();
   double maxOrigin = 0.0;
 
-  for (std::vector<StratumResults>::iterator it = overallResults.strataResults().begin();
+  for (std::vector<StratumResults>::const_iterator it = overallResults.strataResults().begin();
       it != overallResults.strataResults().end(); ++it) { 
 
     maxTip = std::max( maxTip, (*it).flameTipHeight() );
@@ -421,10 +427,25 @@ Results Location::results() const {
   overallResults.flameTipHeight( maxTip );
   overallResults.flameOriginHeight( maxOrigin );
 
+  //the remaining outputs are not reported at the basic output level
+  if (!detailed)
+    return overallResults;
+
+  //****************** Wind reduction factor *******************************************
+
+  //computed with canopy on
+  
+  if (incidentWindSpeed_ <= 0)
+    overallResults.windReductionFactor(1);
+  else
+    overallResults.windReductionFactor(incidentWindSpeed_ / 
+                                       forest_.windProfile(incidentWindSpeed_, 1.5, true));
+
 
 
   //********************** Scorch heights **********************************************
   
+  ffm_trace::Span scorchSpan("scorch heights");
   //McArthur and Luke - McArthur
   overallResults.scorchHeightMcarthur(5.232*pow(overallResults.flameTipHeight(), 0.7));
   overallResults.scorchHeightLukeMcarthur(6*overallResults.flameTipHeight());
@@ -446,9 +467,12 @@ Results Location::results() const {
   overallResults.scorchHeightVanWagnerWithWind(0.74183*pow(byramIntensity,0.667)/
                                                (pow(0.025574*byramIntensity + 0.021433*pow(wind,3),0.5)*
                                                 (60 - weather_.airTempC())));
+  scorchSpan.end();
 
   //********************** Type of crown fire *****************************************
 
+  ffm_trace::Span crownSpan("crown fire");
+
   if (overallResults.strataResults().empty())
     overallResults.crownFireType(Results::UNCLASSIFIED);
   else {
@@ -468,17 +492,15 @@ Results Location::results() const {
   else{
     //want the maximum horizontal run in any canopy stratum path for any species
     double maxRun = 0;
-    for (const IgnitionPath& ip : fir.paths()) {
-      if (ip.level() != Stratum::CANOPY || ip.type() != IgnitionPath::STRATUM_PATH)
-        continue;
-      maxRun = std::max(maxRun, ip.maxHorizontalRun());
-    }
+    for (int i : fir.pathIndices(Stratum::CANOPY, IgnitionPath::STRATUM_PATH))
+      maxRun = std::max(maxRun, fir.paths()[i].maxHorizontalRun());
     overallResults.crownRunLength(maxRun);
   }
   
   //******************** Velocity of crown runs ***************************************
 
   overallResults.crownRunVelocity(fir.speciesWeightedBasicROS(Stratum::CANOPY));
+  crownSpan.end();
 
   //******************** Flame depth **************************************************
 
@@ -492,6 +514,13 @@ Results Location::results() const {
   }
   overallResults.flameDepth(maxDepth);
 
+  //the runs are only kept for printing, and are no longer needed here
+  if (keepRuns) {
+    overallResults.addRun(std::move(fir1));
+    if (runTwoExists)
+      overallResults.addRun(std::move(fir2));
+  }
+
   return overallResults;
 
 }
@@ -500,6 +529,8 @@ Results Location::results() const {
 /*!\brief Provides a complete description of the ignition of the Forest
 \param includeCanopy If false then the canopy layer is left out when 
 computing the wind field.
+\param keepPreIgnitionData If true the pre-ignition data records are kept in the 
+ignition paths.
 \return A ForestIgnitionRun object which provides a complete description 
 of the ignition of the forest, including all plant and stratum 
 ignition paths and the time series (vector) of combined flames 
@@ -551,10 +582,13 @@ for the next stratum.
 
 The computation then proceeds to the next highest stratum, and the process is repeated.
 */
-ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
+ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy, 
+                                              const bool& keepPreIgnitionData) const {
 
   const bool PLANT_IGNITION_RUN = true;
 
+  ffm_trace::Span span("forestIgnitionRun", includeCanopy ? "with canopy" : "without canopy");
+
   //ignition paths for species and strata. This is what will be returned by this method
   ForestIgnitionRun ignitionRun(forest()); 
   ignitionRun.type(includeCanopy ? ForestIgnitionRun::WITH_CANOPY : ForestIgnitionRun::WITHOUT_CANOPY);
@@ -662,9 +696,16 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
     //bool for whether connection 
     bool connection = false;
 
+    //species of this stratum, with their identifiers and shared copies for the ignition paths
+    const std::vector<Species>& allSpecies = strat.allSpecies();
+    const std::vector<int>& speciesIds = forest_.speciesIds(strat.level());
+    const std::vector<std::shared_ptr<const Species>>& speciesHandles = forest_.speciesHandles(strat.level());
+
     if (strat.includeForIgnition()) {
+      ffm_trace::Span plantSpan("plant ignition", levelStringMap.at(strat.level()));
       //first loop over the species - plant ignition
-      for (const Species& spec : strat.allSpecies()) {
+      for (unsigned k = 0; k < allSpecies.size(); ++k) {
+        const Species& spec = allSpecies[k];
 
         double comp = spec.composition();
 
@@ -675,6 +716,8 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
         //loop over ignition point scenarios
         for (int ignitPtScenario = -2; ignitPtScenario <= 2; ++ignitPtScenario) {
 
+          ffm_trace::Span scenarioSpan("plant scenario", spec.name(), ignitPtScenario + 2);
+
           //compute scenario initial ignition point, make sure this is not below the surface
           Pt iPt = spec.crown().pointInBase( 0.25*ignitPtScenario*spec.width());
           if (iPt.y() < iPt.x()*tan(slope()))
@@ -686,10 +729,14 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
               preHeatingFlames, 
               preHeatingEndTime, 
               strat.level(), 
-              spec,
+              speciesHandles[k],
+              speciesIds[k],
+              k,
               0,
               stratumWindSpeed, 
-              iPt);
+              iPt,
+              keepPreIgnitionData);
+          FFM_COUNT(ignitionRun.addCounters(strat.level(), iPath.counters()));
 
           if (iPath.hasSegments()) {  
             // ignition occurred
@@ -761,6 +808,7 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
     //calculation then we continue on to the stratum ignition calc
     //note that the flame lengths were sorted so we only check the first one
     if (!ffm_numerics::leq(speciesWeightedFlameLengths.front(),0)) {
+      ffm_trace::Span stratumSpan("stratum ignition", levelStringMap.at(strat.level()));
       //finish the flame weighting
       unsigned i = 0;
       for (auto& temp : speciesAndFlameWeightedFlameTemps) {
@@ -835,7 +883,9 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
       speciesWeightedFlameOrigins = std::vector<Pt>(ffm_settings::maxTimeSteps, Pt(0,0));
     
       //second loop over species - stratum ignition
-      for (const auto& spec : strat.allSpecies()) {
+      for (unsigned k = 0; k < allSpecies.size(); ++k) {
+        const Species& spec = allSpecies[k];
+        ffm_trace::Span speciesSpan("stratum species", spec.name());
 
         double comp = spec.composition();
 
@@ -850,22 +900,27 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
         Poly stratumPoly(verts);
 
         //make a species based on this polygon
-        Species bigSpecies(comp,
-                           spec.name(),
-                           stratumPoly,
-                           spec.liveLeafMoisture(),
-                           spec.deadLeafMoisture(),
-                           spec.propDead(),
-                           spec.silFreeAshCont(),
-                           spec.ignitTemp(),
-                           spec.leafForm(),
-                           spec.leafThick(),
-                           spec.leafWidth(),
-                           spec.leafLength(),
-                           spec.leafSep(),
-                           spec.stemOrder(),
-                           spec.width(),
-                           std::max(spec.clumpSep(), strat.modelPlantSep() - strat.avWidth()));
+        std::shared_ptr<const Species> bigSpecies = 
+          std::make_shared<const Species>(comp,
+                                          spec.name(),
+                                          stratumPoly,
+                                          spec.liveLeafMoisture(),
+                                          spec.deadLeafMoisture(),
+                                          spec.propDead(),
+                                          spec.silFreeAshCont(),
+                                          spec.ignitTemp(),
+                                          spec.leafForm(),
+                                          spec.leafThick(),
+                                          spec.leafWidth(),
+                                          spec.leafLength(),
+                                          spec.leafSep(),
+                                          spec.stemOrder(),
+                                          spec.width(),
+                                          std::max(spec.clumpSep(), strat.modelPlantSep() - strat.avWidth()));
+
+        //identifier for the stratum path. The modified clump separation means this is not 
+        //necessarily the same species as spec, in which case the path is not associated with spec
+        int bigSpeciesId = forest_.speciesRegistry().find(*bigSpecies);
       
         //initialise an ignition path for the stratum ignition
         IgnitionPath speciesIgnitionPath;
@@ -883,9 +938,13 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
                                                     0,
                                                     strat.level(),
                                                     bigSpecies, 
+                                                    bigSpeciesId,
+                                                    k,
                                                     canopyHeatingDistance,
                                                     stratumWindSpeed,
-                                                    iPt); 
+                                                    iPt,
+                                                    keepPreIgnitionData); 
+          FFM_COUNT(ignitionRun.addCounters(strat.level(), speciesIgnitionPath.counters()));
         }
 
 
@@ -900,11 +959,11 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
 
           int i = 0;
           for (const Seg& sg : speciesIgnitionPath.ignitedSegments()){
-            double flameLen = bigSpecies.flameLength(sg.length());
+            double flameLen = bigSpecies->flameLength(sg.length());
             speciesWeightedFlameLengths.at(i) += comp*flameLen;
             speciesWeightedFlameDepths.at(i) += comp*sg.length();
             speciesAndFlameWeightedFlameTemps.at(i) += comp*flameLen*
-              (bigSpecies.isGrass() && strat.level() == Stratum::NEAR_SURFACE ? 
+              (bigSpecies->isGrass() && strat.level() == Stratum::NEAR_SURFACE ? 
                ffm_settings::grassFlameDeltaTemp : ffm_settings::mainFlameDeltaTemp);
             speciesWeightedFlameOrigins.at(i) += comp*sg.start();
             ++i;
@@ -1045,10 +1104,14 @@ ForestIgnitionRun Location::forestIgnitionRun(const bool& includeCanopy) const {
   that the direct heating starts. This may be earlier than the end time of any or 
   all of the pre-heating flames.
   \param level The Stratum::LevelType in which the ignition path is being computed.
-  \param spec This is the Species object through which the ignition path is being computed. 
+  \param species This is the Species object (spec) through which the ignition path is being computed. 
   In the case that this is a stratum ignition run then spec will be a Species object 
   with a modified crown and a modified clump separation attribute, and will represent 
-  a stratum made up of this single species.
+  a stratum made up of this single species. The returned path shares this object.
+  \param speciesId The Forest::speciesRegistry() identifier of spec, which is 
+  recorded in the returned path.
+  \param speciesIndex The position of the Species of the stratum from which spec was 
+  derived, which is recorded in the returned path.
   \param canopyHeatingDistance If plantFlameRun == false and level == CANOPY then 
   the flame residence time is reduced to ffm_settings::reducedCanopyFlameResidenceTime 
   for points whose x-coordinate exceed canopyHeatingDistance.
@@ -1100,20 +1163,70 @@ Having computed the ignited segment, the computation proceeds to the next time s
 It ceases when ffm_settings::maxTimeSteps have elapsed, when both the incident and plant 
 flames have extinguished, or when there is no further potential path of ignition through 
 the plant, ie when the ignition path has reached the top or side of the plant.
+PreIgnitionData records of the drying and heating at the first test point are built only
+if keepPreIgnitionData is true or a PreIgnitionObserver is attached, otherwise only their
+maximum temperature is noted in the path.
+*/
+IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFlames,
+                                           const bool& plantFlameRun,
+                                           std::vector<PreHeatingFlame> preHeatingFlames,
+                                           const double& preHeatingEndTime,
+                                           const Stratum::LevelType& level,
+                                           const std::shared_ptr<const Species>& species,
+                                           const int& speciesId,
+                                           const int& speciesIndex,
+                                           const double& canopyHeatingDistance,
+                                           const double& windSpeed,
+                                           const Pt& initialPt,
+                                           const bool& keepPreIgnitionData) const { 
+  if (keepPreIgnitionData || preIgnitionObserver_)
+    return computeIgnitionPath<true>(incidentFlames, plantFlameRun, std::move(preHeatingFlames),
+                                     preHeatingEndTime, level, species, speciesId, speciesIndex,
+                                     canopyHeatingDistance, windSpeed, initialPt, keepPreIgnitionData);
+  return computeIgnitionPath<false>(incidentFlames, plantFlameRun, std::move(preHeatingFlames),
+                                    preHeatingEndTime, level, species, speciesId, speciesIndex,
+                                    canopyHeatingDistance, windSpeed, initialPt, false);
+}
+
+/*!\brief Passes a pre-ignition data record to the observer, if any, and keeps it in the path
+  \param iPath
+  \param data
+  \param keep If false the path only notes the temperature of the record
+*/
+void Location::recordPreIgnitionData(IgnitionPath& iPath, const PreIgnitionData& data, 
+                                     const bool& keep) const {
+  if (keep)
+    iPath.addPreIgnitionData(data);
+  else
+    iPath.notePreIgnitionTemp(data.temperature());
+  if (preIgnitionObserver_)
+    preIgnitionObserver_->observe(iPath, data);
+}
+
+/*!\brief The ignition path computation of computeIgnitionPath()
+
+  With DIAGNOSE false no PreIgnitionData records are built, the path only notes their
+  temperatures, which select among the plant ignition scenarios.
 */
+template<bool DIAGNOSE>
 IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFlames,
                                            const bool& plantFlameRun,
                                            std::vector<PreHeatingFlame> preHeatingFlames,
                                            const double& preHeatingEndTime,
                                            const Stratum::LevelType& level,
-                                           const Species& spec,
+                                           const std::shared_ptr<const Species>& species,
+                                           const int& speciesId,
+                                           const int& speciesIndex,
                                            const double& canopyHeatingDistance,
                                            const double& windSpeed,
-                                           const Pt& initialPt) const { 
+                                           const Pt& initialPt,
+                                           const bool& keepPreIgnitionData) const { 
+
+  const Species& spec = *species;
 
   //initialise ignition path 
   IgnitionPath iPath(plantFlameRun ? IgnitionPath::PLANT_PATH : IgnitionPath::STRATUM_PATH,
-                     level, spec, -99);
+                     level, species, speciesId, speciesIndex, -99);
 
   //pop the last pre-heating flame off the vector of pre-heating flames because that level will
   //provide the direct heating
@@ -1130,11 +1243,16 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
   bool ignition = false;
   int safetyCounter = 1;
 
+  FFM_COUNT(IgnitionCounters counters);
+  FFM_COUNT(++counters.calls);
+  FFM_COUNT(IgnitionCounters::EndReason endReason = IgnitionCounters::MAX_TIME_STEPS);
+
   //we loop over an indeterminate number of time steps, but no more 
   //than maxTimeSteps counted from when ignition occurs. This is why
   //we use safetyCounter instead of timeStep in the loop condition. 
 
   for (int timeStep = 1; safetyCounter <= (ffm_settings::maxTimeSteps) ; ++timeStep) {
+    FFM_COUNT(++counters.timeSteps);
 
     //for plant flame, and only if required, we modify wind speed by 
     //reducing it by speed of flame progression
@@ -1162,8 +1280,8 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
     if (plantFlame.isNull() && incidentFlame.isNull()) {
       if (timeStep <= incidentFlames.size())
         continue; 
-      else
-        break;
+      FFM_COUNT(endReason = IgnitionCounters::FLAMES_EXTINGUISHED);
+      break;
     }
 
     //compute potential ignition distance for plant flame 
@@ -1172,6 +1290,7 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
       Ray r(iPt, plantFlame.angle());
       double intsctLen = r.intersectionLength(spec.crown());
       double ignitLen = plantFlame.inversePlumeTemperature(spec.ignitionTemp(),weather_.airTempC());
+      FFM_COUNT(counters.rayIntersections += 2);
       maxPlantPath = std::min(r.intersectionLength(spec.crown()),
                               plantFlame.inversePlumeTemperature(spec.ignitionTemp(),weather_.airTempC()));
     }
@@ -1193,6 +1312,7 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
         incidentFlameOrigin = incidentFlame.origin();
       Ray r(iPt, incidentFlame.angle());
       double pathDistance = r.intersectionLength(spec.crown());
+      FFM_COUNT(++counters.rayIntersections);
       double ignitionDistance = 
         std::max(0.0,
                  incidentFlame.inversePlumeTemperature(spec.ignitionTemp(),weather_.airTempC()) 
@@ -1233,6 +1353,7 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
       //segment in turn for ignition
       for(int step = 1; step <= ffm_settings::numPenetrationSteps; ++step) {
         Pt testPt = ePt + (pathLength/ffm_settings::numPenetrationSteps)*Pt(cos(pathAngle),sin(pathAngle));
+        FFM_COUNT(++counters.penetrationSteps);
         double dryingFactor = 1;
         double dryingTemp;
 
@@ -1246,14 +1367,21 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
             //compute the IDT at the test point
             double idt = spec.ignitionDelayTime(dryingTemp) * 
               (isGrass ? ffm_settings::grassIDTReduction : 1.0);
+            FFM_COUNT(++counters.dryingFlameEvaluations);
+            FFM_COUNT(++counters.ignitionDelayTimeCalls);
             
             double duration = phf.duration(preHeatingEndTime);
             dryingFactor *= std::max(0.0, 1 - duration / idt);
 
             if (iPt == initialPt && timeStep == 1 && step == 1) {
-              iPath.addPreIgnitionData( PreIgnitionData::preheating(
+              if constexpr (DIAGNOSE)
+                recordPreIgnitionData(iPath, 
+                                      PreIgnitionData::preheating(
                                       phf.flame().flameLength(), phf.flame().depthIgnited(), 
-                                      distToFlame, dryingFactor, dryingTemp, duration) );
+                                      distToFlame, dryingFactor, dryingTemp, duration),
+                                      keepPreIgnitionData);
+              else
+                iPath.notePreIgnitionTemp(dryingTemp);
             }
           }
 
@@ -1276,6 +1404,8 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
             dryingTemp = dryingFlame.plumeTemperature((testPt - dryingFlameOrigin).norm(), weather_.airTempC());
             double dryingIDT = spec.ignitionDelayTime(dryingTemp)* 
               (isGrass ? ffm_settings::grassIDTReduction : 1.0);
+            FFM_COUNT(++counters.dryingFlameEvaluations);
+            FFM_COUNT(++counters.ignitionDelayTimeCalls);
             dryingFactor *= std::max(0.0,1 - ffm_settings::computationTimeInterval / dryingIDT);
           }
         }
@@ -1287,6 +1417,8 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
             dryingTemp = dryingFlame.plumeTemperature(testPt, weather_.airTempC());
             double dryingIDT = spec.ignitionDelayTime(dryingTemp)* 
               (isGrass ? ffm_settings::grassIDTReduction : 1.0);
+            FFM_COUNT(++counters.dryingFlameEvaluations);
+            FFM_COUNT(++counters.ignitionDelayTimeCalls);
             dryingFactor *= std::max(0.0, 1 - ffm_settings::computationTimeInterval / dryingIDT);
           }
         }
@@ -1298,12 +1430,17 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
         double maxTemp = std::max(incidentTemp, plantTemp);
         double idt = dryingFactor * spec.ignitionDelayTime(maxTemp)* 
           (isGrass ? ffm_settings::grassIDTReduction : 1.0);
+        FFM_COUNT(++counters.ignitionDelayTimeCalls);
 
         if (iPt == initialPt && step == 1) {
-          iPath.addPreIgnitionData( 
-              PreIgnitionData::incident(
-                      incidentFlame.flameLength(), incidentFlame.depthIgnited(), 
-                      distToIncidentFlame, dryingFactor, incidentTemp, idt) );
+          if constexpr (DIAGNOSE)
+            recordPreIgnitionData(iPath, 
+                PreIgnitionData::incident(
+                        incidentFlame.flameLength(), incidentFlame.depthIgnited(), 
+                        distToIncidentFlame, dryingFactor, incidentTemp, idt),
+                keepPreIgnitionData);
+          else
+            iPath.notePreIgnitionTemp(incidentTemp);
         }
 
         //if ignition does not occur for testPt then break from loop over penetration steps
@@ -1349,8 +1486,10 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
         if(!ffm_numerics::almostZero(maxIncidentPath) || !ffm_numerics::almostZero(maxPlantPath) || segStart != ePt) {
           iPath.addSegment(Seg(segStart, ePt));
           plantFlames.push_back(iPath.flame(modifiedWindSpeed, slope()));
-        } else
+        } else {
+          FFM_COUNT(endReason = IgnitionCounters::NO_FURTHER_PATH);
           break; //from loop over time steps
+        }
       }
       //reset ignition point
       iPt = ePt;
@@ -1358,6 +1497,8 @@ IgnitionPath Location::computeIgnitionPath(const std::vector<Flame>& incidentFla
       ++safetyCounter;
     }
   }//end of loop over time steps
+  FFM_COUNT(++counters.endReasons[endReason]);
+  FFM_COUNT(iPath.counters(counters));
   return iPath;
 }
 
@@ -8,6 +8,7 @@
 #include "weather.h"
 #include "ignition_path.h"
 #include "forest_ignition_run.h"
+#include "pre_ignition_observer.h"
 #include "results.h"
 
 class Flame;
@@ -37,11 +38,16 @@ public:
   Weather weather() const;
   double incidentWindSpeed() const;
   double firelineLength() const; 
+  PreIgnitionObserver* preIgnitionObserver() const;
+
+  //mutators
+
+  void preIgnitionObserver(PreIgnitionObserver* observer);
 
   //accessors from data members
 
   double slope() const;
-  std::vector<Stratum> strata() const;
+  const std::vector<Stratum>& strata() const;
 
   //printing
 
@@ -53,16 +59,21 @@ public:
   bool empty() const;
 
   //main fire computations
-  Results results() const;
+  Results results(const Results::OutputLevelType& outputLevel = Results::COMPREHENSIVE) const;
 
 private:
 
+  //the kernel microbenchmarks (bench/kernel_bench.cc) time computeIgnitionPath directly
+  friend class KernelBench;
+
   Forest forest_ ;
   Weather weather_ ;
   double incidentWindSpeed_;
   double firelineLength_;
+  PreIgnitionObserver* preIgnitionObserver_;
 
-  ForestIgnitionRun forestIgnitionRun(const bool& withCanopy = true) const;
+  ForestIgnitionRun forestIgnitionRun(const bool& withCanopy = true, 
+				      const bool& keepPreIgnitionData = false) const;
   //computes all ignition paths in a forest
 
   IgnitionPath computeIgnitionPath(const std::vector<Flame>& incidentFlames,
@@ -70,11 +81,32 @@ private:
 				   std::vector<PreHeatingFlame> preHeatingFlames,
 				   const double& preHeatingEndTime,
 				   const Stratum::LevelType& level,
-				   const Species& spec, 
+				   const std::shared_ptr<const Species>& species, 
+				   const int& speciesId,
+				   const int& speciesIndex,
 				   const double& canopyHeatingDistance,
 				   const double& windSpeed,
-				   const Pt& initialPt) const;
+				   const Pt& initialPt,
+				   const bool& keepPreIgnitionData = false) const;
 //computes ignition path in a species or stratum fire
+
+  template<bool DIAGNOSE>
+  IgnitionPath computeIgnitionPath(const std::vector<Flame>& incidentFlames,
+				   const bool& plantFlameRun,
+				   std::vector<PreHeatingFlame> preHeatingFlames,
+				   const double& preHeatingEndTime,
+				   const Stratum::LevelType& level,
+				   const std::shared_ptr<const Species>& species, 
+				   const int& speciesId,
+				   const int& speciesIndex,
+				   const double& canopyHeatingDistance,
+				   const double& windSpeed,
+				   const Pt& initialPt,
+				   const bool& keepPreIgnitionData) const;
+//the computation, with or without building pre-ignition data records
+
+  void recordPreIgnitionData(IgnitionPath& iPath, const PreIgnitionData& data, 
+			     const bool& keep) const;
 };
 
 #include "location_inline.h"
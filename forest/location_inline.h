@@ -6,7 +6,8 @@
 //constructors
 
 /*!\brief Default constructor.*/
-inline Location::Location() : forest_(), weather_(), incidentWindSpeed_(-999), firelineLength_(-999){}
+inline Location::Location() : forest_(), weather_(), incidentWindSpeed_(-999), firelineLength_(-999),
+			      preIgnitionObserver_(nullptr) {}
 
 /*!\brief Standard constructor. 
   \param forest
@@ -18,7 +19,8 @@ inline Location::Location(const Forest& forest,
 			  const Weather& weather, 
 			  const double& incidentWindSpeed, 
 			  const double& firelineLength) :
-  forest_(forest), weather_(weather), incidentWindSpeed_(incidentWindSpeed), firelineLength_(firelineLength) {};
+  forest_(forest), weather_(weather), incidentWindSpeed_(incidentWindSpeed), firelineLength_(firelineLength),
+  preIgnitionObserver_(nullptr) {};
 
 //accessors for member functions
 
@@ -42,6 +44,18 @@ inline double Location::incidentWindSpeed() const {return incidentWindSpeed_;}
 */
 inline double Location::firelineLength() const {return firelineLength_;}
 
+/*!\brief The observer of pre-ignition data
+  \return The observer, or nullptr if none is attached
+*/
+inline PreIgnitionObserver* Location::preIgnitionObserver() const {return preIgnitionObserver_;}
+
+//mutators
+
+/*!\brief Attaches an observer of pre-ignition data, which is not owned
+  \param observer Called with each record computed by results(), or nullptr to detach
+*/
+inline void Location::preIgnitionObserver(PreIgnitionObserver* observer) {preIgnitionObserver_ = observer;}
+
 //accessors from data members
 
 /*!\brief Slope of the surface
@@ -52,7 +66,7 @@ inline double Location::slope() const {return forest_.surface().slope();}
 /*!\brief The strata of the Forest
   \return forest().strata()
 */
-inline std::vector<Stratum> Location::strata() const {return forest_.strata();}
+inline const std::vector<Stratum>& Location::strata() const {return forest_.strata();}
 
 //other methods
 
@@ -43,8 +43,8 @@ public:
   double scorchHeightLukeMcarthur() const;
   double scorchHeightVanWagner() const;
   double scorchHeightVanWagnerWithWind() const;
-  std::vector<StratumResults> strataResults() const;
-  std::vector<ForestIgnitionRun> runs() const;
+  const std::vector<StratumResults>& strataResults() const;
+  const std::vector<ForestIgnitionRun>& runs() const;
   bool runTwoExists() const;
 
   //mutators
@@ -69,6 +69,8 @@ public:
   void scorchHeightVanWagnerWithWind(const double& ht);
   void addStratumResults(const StratumResults&);
   void addRun(const ForestIgnitionRun&);
+  void addRun(ForestIgnitionRun&&);
+  void runTwoExists(const bool& done);
 
   //other methods
 
@@ -127,6 +129,9 @@ private:
   //comprehensive outputs are those above plus the following vector which 
   //has at most two components
   std::vector<ForestIgnitionRun>  runs_ =  std::vector<ForestIgnitionRun>();
+
+  //whether the second run was done, which is known even when the runs are not kept
+  bool runTwoExists_ = false;
   
 };
 
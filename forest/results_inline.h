@@ -106,16 +106,17 @@ inline double Results::scorchHeightVanWagnerWithWind() const {return scorchHeigh
   /*!\brief Accesses the vector of stratum specific results
     \return The vector of StratumResults
   */
-inline std::vector<StratumResults> Results::strataResults() const {return strataResults_;}
+inline const std::vector<StratumResults>& Results::strataResults() const {return strataResults_;}
 
   /*!\brief The ForestIgnitionRun objects
     \return The vector of ForestIgnitionRun objects computed by the model
 
-    This vector has at least one and at most two elements. The second element, if 
-    it exists, is the ForestIgnitionRun object produced using the windfield computed
-    as if the canopy Stratum did not exist
+    This vector has at most two elements, and is empty unless the results were computed
+    for the COMPREHENSIVE output level. The second element, if it exists, is the 
+    ForestIgnitionRun object produced using the windfield computed as if the canopy 
+    Stratum did not exist
   */
-inline std::vector<ForestIgnitionRun> Results::runs() const {return runs_;}
+inline const std::vector<ForestIgnitionRun>& Results::runs() const {return runs_;}
 
   /*!\brief Was a second run done?
     \return true if and only if a second run was done
@@ -123,7 +124,7 @@ inline std::vector<ForestIgnitionRun> Results::runs() const {return runs_;}
     This refers to the second run done with the wind field 
     computed as if the canopy stratum was missing
   */
-inline bool Results::runTwoExists() const {return runs_.size() == 2;}
+inline bool Results::runTwoExists() const {return runTwoExists_;}
 
 //mutators
 
@@ -270,13 +271,28 @@ inline void Results::addStratumResults(const StratumResults& sr) {strataResults_
 
   Adds fir to the vector of all ForestIgnitionRun objects
 */
-inline void Results::addRun(const ForestIgnitionRun& fir) {
-  if (runs_.empty() && fir.type() == ForestIgnitionRun::WITH_CANOPY)
-    runs_.push_back(fir);
-  if (runs_.size() == 1 && fir.type() == ForestIgnitionRun::WITHOUT_CANOPY)
-    runs_.push_back(fir);
+inline void Results::addRun(const ForestIgnitionRun& fir) {addRun(ForestIgnitionRun(fir));}
+
+/*!\brief Adds a ForestIgnitionRun object to the vector of all such runs
+  \param fir (ForestIgnitionRun)
+
+  Moves fir into the vector of all ForestIgnitionRun objects
+*/
+inline void Results::addRun(ForestIgnitionRun&& fir) {
+  if ((runs_.empty() && fir.type() == ForestIgnitionRun::WITH_CANOPY) ||
+      (runs_.size() == 1 && fir.type() == ForestIgnitionRun::WITHOUT_CANOPY))
+    runs_.push_back(std::move(fir));
+  if (runs_.size() == 2)
+    runTwoExists_ = true;
 }
 
+/*!\brief Records whether a second run was done
+  \param done
+
+  For results whose runs are not kept
+*/
+inline void Results::runTwoExists(const bool& done) {runTwoExists_ = done;}
+
 //other methods
 
 /*!\brief Test for existence of strataResults
@@ -63,8 +63,8 @@ class Species{
 
   bool          isValid() const;
   double        composition() const;
-  std::string   name() const;
-  Poly          crown() const;
+  const std::string& name() const;
+  const Poly&   crown() const;
   double        liveLeafMoisture() const;
   double        deadLeafMoisture() const;
   double        propDead() const;
@@ -82,6 +82,7 @@ class Species{
   //mutators
 
   void composition(const double& composition);
+  void deadLeafMoisture(const double& deadLeafMoisture);
 
   // other methods
 
@@ -140,7 +141,25 @@ private:
   double       clumpSep_ = -99;
   double       clumpDiam_ = -99;
 
-
+  /*!\brief Quantities derived from the traits above
+
+    These depend only on the traits, so they are computed once by computeDerived() when 
+    the Species is constructed. Only the dead leaf moisture can change afterwards, and 
+    computeMoistureDerived() then recomputes the quantities that depend on it.
+  */
+  struct DerivedProperties {
+    double leafMoisture = -99;
+    double ignitionTemp = -99;
+    double flameDuration = -99;
+    double leafFlameLength = -99;
+    double leavesPerClump = -99;
+    double leafAreaIndex = -99;
+  };
+
+  DerivedProperties derived_;
+
+  void computeDerived();
+  void computeMoistureDerived();
  };
 
 
@@ -5,7 +5,9 @@
 //constructors
 
 /*!\brief Default constructor*/
-inline Species::Species() {}
+inline Species::Species() {
+  computeDerived();
+}
 
   /*!\brief Basic constructor.
     \param composition 
@@ -97,6 +99,7 @@ inline Species::Species(const double& composition,
     clumpDiam_ = -99;
     clumpSep_ = -99;
   }
+  computeDerived();
 }
 
 /*!\brief Constructs a species with hexagonal crown. 
@@ -196,6 +199,7 @@ inline Species::Species(const double& composition,
     clumpSep_ = -99;
     composition_ = 0;
   }
+  computeDerived();
 }
 
 //accessors
@@ -209,12 +213,12 @@ inline double      Species::composition() const {return composition_;}
 /*!\brief Species name
   \return The name of the species.
 */
-inline std::string  Species::name() const {return name_;}
+inline const std::string& Species::name() const {return name_;}
 
 /*!\brief The crown
 \return The Poly representing the species crown.
 */
-inline Poly         Species::crown() const{return crown_;}
+inline const Poly& Species::crown() const{return crown_;}
 
 /*!\brief Live leaf moisture
   \return The live leaf moisture
@@ -295,6 +299,19 @@ inline void Species::composition(const double& composition) {
   composition_ = std::max(0.0,composition);
 }
 
+/*!\brief Sets the dead leaf moisture of the Species
+  \param dead_leaf_moisture Proportion of oven dried weight
+
+  The leaf moisture, flame duration and leaf flame length are recomputed, while the 
+  other derived properties do not depend on moisture and are left as they are. An 
+  invalid Species is not changed.
+*/
+inline void Species::deadLeafMoisture(const double& dead_leaf_moisture) {
+  if (!isValid_ || dead_leaf_moisture == deadLeafMoisture_) return;
+  deadLeafMoisture_ = dead_leaf_moisture;
+  computeMoistureDerived();
+}
+
 
 // other methods
 
@@ -307,15 +324,14 @@ inline double Species::width() const {return crown_.width();}
   \return Weighted average of live and dead leaf moistures based on proportion of dead leaves
 */
 inline double Species::leafMoisture() const {
-  return (1 - propDead_)*liveLeafMoisture_ + propDead_*deadLeafMoisture_;
+  return derived_.leafMoisture;
 }
 
 /*!\brief Flame duration model
   \return Flame duration in seconds
 */
 inline double Species::flameDuration() const{
-  return std::max(1.37*leafWidth_*leafThick_*1.0e6 + 1.61*leafMoisture() - 0.027,
-	     ffm_settings::computationTimeInterval);
+  return derived_.flameDuration;
 }
 
 /*!\brief Modelled ignition temperature
@@ -325,9 +341,9 @@ inline double Species::flameDuration() const{
   return -99 if it is not possible to model ignition temperature and ignitTemp() < 0.
 */
 inline double Species::ignitionTemp(bool modelIt) const{
-  if (silFreeAshCont_ < 0 && ignitTemp_ < 0) return -99; 
-  if (ignitTemp_ < 0 || (modelIt && silFreeAshCont_ > 0))  return 354 - 13.9*log(silFreeAshCont_*100) - 2.91*pow(log(silFreeAshCont_*100),2);
-  return ignitTemp_;
+  if (modelIt && silFreeAshCont_ > 0)  
+    return 354 - 13.9*log(silFreeAshCont_*100) - 2.91*pow(log(silFreeAshCont_*100),2);
+  return derived_.ignitionTemp;
 }
 
 /*!\brief Ignition delay time model
@@ -354,21 +370,14 @@ inline bool Species::isGrass() const {
   \return Leaf flame length (m)
 */
 inline double Species::leafFlameLength() const {
-
-  double area = 0.5*leafWidth_*leafLength_; 
-  double sqRootArea = pow(area,0.5);
-  double cubeRootArea = pow(area,1/3.0);
-  if(leafMoisture() < (17.5*cubeRootArea - 52.5*sqRootArea - 0.0027)/0.277)
-    return 1.75*cubeRootArea - 0.0277*leafMoisture() - 0.00027;
-  else
-    return 5.25*sqRootArea;
+  return derived_.leafFlameLength;
 }
 
 /*!\brief Leaf density model
   \return Leaves per clump
 */
 inline double Species::leavesPerClump() const {
-  return 0.88*pow(clumpDiam_*stemOrder_/leafSep_,1.18);
+  return derived_.leavesPerClump;
 }
 
 //merged leaf flame length model (Zylstra thesis Eq 5.76)
@@ -392,11 +401,60 @@ inline double Species::flameLength(const double& lengthIgnitedSeg) const {
   \return Leaf area index of Species
 */
 inline double Species::leafAreaIndex() const {
-  return leafWidth_*leafLength_/2.0                     //one side leaf area
-    * leavesPerClump()                        //leaves per clump
-    * crown_.volumeOfRev()                             //volume of crown
-    / (4.0/3.0*PI*pow((clumpDiam_ + clumpSep_)*0.5,3))    //volume of clump
-    / (PI*pow(0.5*crown_.width(),2));                      //area covered on ground
+  return derived_.leafAreaIndex;
+}
+
+/*!\brief Computes the derived properties from the species traits
+
+  Called once at the end of each constructor. The accessors leafMoisture(), 
+  ignitionTemp(), flameDuration(), leafFlameLength(), leavesPerClump() and 
+  leafAreaIndex() return the values stored here.
+*/
+inline void Species::computeDerived() {
+  computeMoistureDerived();
+
+  //ignition temperature, modelled from silica free ash content if not supplied
+  if (silFreeAshCont_ < 0 && ignitTemp_ < 0) 
+    derived_.ignitionTemp = -99; 
+  else if (ignitTemp_ < 0)
+    derived_.ignitionTemp = 354 - 13.9*log(silFreeAshCont_*100) - 2.91*pow(log(silFreeAshCont_*100),2);
+  else
+    derived_.ignitionTemp = ignitTemp_;
+
+  //leaf density model
+  derived_.leavesPerClump = 0.88*pow(clumpDiam_*stemOrder_/leafSep_,1.18);
+
+  //leaf area index model, undefined for an empty crown
+  if (crown_.vertices().empty()) 
+    derived_.leafAreaIndex = -99;
+  else
+    derived_.leafAreaIndex = leafWidth_*leafLength_/2.0         //one side leaf area
+      * derived_.leavesPerClump                                 //leaves per clump
+      * crown_.volumeOfRev()                                    //volume of crown
+      / (4.0/3.0*PI*pow((clumpDiam_ + clumpSep_)*0.5,3))        //volume of clump
+      / (PI*pow(0.5*crown_.width(),2));                         //area covered on ground
+}
+
+/*!\brief Computes the derived properties that depend on the dead leaf moisture
+
+  Called by computeDerived() and again whenever deadLeafMoisture() is set.
+*/
+inline void Species::computeMoistureDerived() {
+  //leaf moisture, weighted average of live and dead leaf moistures
+  derived_.leafMoisture = (1 - propDead_)*liveLeafMoisture_ + propDead_*deadLeafMoisture_;
+
+  //flame duration model
+  derived_.flameDuration = std::max(1.37*leafWidth_*leafThick_*1.0e6 + 1.61*derived_.leafMoisture - 0.027,
+				    ffm_settings::computationTimeInterval);
+
+  //leaf flame length model
+  double area = 0.5*leafWidth_*leafLength_; 
+  double sqRootArea = pow(area,0.5);
+  double cubeRootArea = pow(area,1/3.0);
+  if(derived_.leafMoisture < (17.5*cubeRootArea - 52.5*sqRootArea - 0.0027)/0.277)
+    derived_.leafFlameLength = 1.75*cubeRootArea - 0.0277*derived_.leafMoisture - 0.00027;
+  else
+    derived_.leafFlameLength = 5.25*sqRootArea;
 }
 
 
@@ -0,0 +1,48 @@
+#ifndef SPECIES_REGISTRY_H
+#define SPECIES_REGISTRY_H
+
+#include <memory>
+#include <vector>
+
+#include "species.h"
+
+/*!\brief A SpeciesRegistry assigns compact integer identifiers to Species
+
+  Two Species objects receive the same identifier if and only if they are the same 
+  species in the sense of Species::sameSpecies(), ie they differ at most in composition, 
+  crown and clump diameter. This is the association used to match an IgnitionPath 
+  through a stratum type crown with the plant Species it was derived from, so ignition 
+  paths can be matched to species by comparing identifiers.
+
+  The registry holds shared handles to the Species rather than copies, so that it adds 
+  no copy of a Species to the Forest that owns it.
+*/
+
+class SpeciesRegistry{
+
+public:
+
+  ///Value returned by find() for a Species that has not been registered.
+  static const int NO_SPECIES = -1;
+
+  //constructors
+
+  SpeciesRegistry();
+
+  //other methods
+
+  int intern(const std::shared_ptr<const Species>& species);
+  int find(const Species& species) const;
+  const Species& species(const int& id) const;
+  int size() const;
+  bool empty() const;
+
+private:
+
+  //the first Species registered under each identifier
+  std::vector<std::shared_ptr<const Species>> species_;
+};
+
+#include "species_registry_inline.h"
+
+#endif //SPECIES_REGISTRY_H
@@ -0,0 +1,56 @@
+#ifndef SPECIES_REGISTRY_INLINE_H
+#define SPECIES_REGISTRY_INLINE_H
+
+//constructors
+
+/*!\brief Default constructor produces an empty registry*/
+inline SpeciesRegistry::SpeciesRegistry() : species_() {}
+
+//other methods
+
+/*!\brief Identifier of a Species, registering it if necessary
+  \param species A handle to the Species, which is shared rather than copied
+  \return The identifier of the registered Species that is the same species as 
+  species, or a new identifier if there is no such Species.
+*/
+inline int SpeciesRegistry::intern(const std::shared_ptr<const Species>& species) {
+  int id = find(*species);
+  if (id != NO_SPECIES) return id;
+  species_.push_back(species);
+  return static_cast<int>(species_.size()) - 1;
+}
+
+/*!\brief Identifier of a registered Species
+  \param species
+  \return The identifier of the registered Species that is the same species as 
+  species, or NO_SPECIES if there is no such Species.
+*/
+inline int SpeciesRegistry::find(const Species& species) const {
+  for (int i = 0; i < static_cast<int>(species_.size()); ++i)
+    if (species_[i]->sameSpecies(species)) return i;
+  return NO_SPECIES;
+}
+
+/*!\brief Extract a registered Species
+  \param id
+  \return The first Species registered under identifier id.
+*/
+inline const Species& SpeciesRegistry::species(const int& id) const {
+  return *species_.at(id);
+}
+
+/*!\brief Number of registered species
+  \return The number of distinct identifiers assigned.
+*/
+inline int SpeciesRegistry::size() const {
+  return static_cast<int>(species_.size());
+}
+
+/*!\brief Test for an empty registry
+  \return true if and only if no Species has been registered.
+*/
+inline bool SpeciesRegistry::empty() const {
+  return species_.empty();
+}
+
+#endif //SPECIES_REGISTRY_INLINE_H
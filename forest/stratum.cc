@@ -23,7 +23,10 @@ Stratum::Stratum(const Stratum::LevelType& level,
   plantSep_(-99)
 {
   //must have a known level
-  if (level == UNKNOWN_LEVEL) return;
+  if (level == UNKNOWN_LEVEL) {
+    computeDerived();
+    return;
+  }
   //species  vector must be non-empty and the 
   //plant separation is allowed to be negative
   //in which case it is considered to be N/A and is set to -99
@@ -49,7 +52,10 @@ Stratum::Stratum(const Stratum::LevelType& level,
       exit(1);
     }
   }
-  if (sum == 0) return; //an empty stratum
+  if (sum == 0) { //an empty stratum
+    computeDerived();
+    return;
+  }
 
   for(auto& s : allSpecies_) 
     s.composition(s.composition() / sum);
@@ -57,72 +63,52 @@ Stratum::Stratum(const Stratum::LevelType& level,
   if (plantSeparation >= 0) plantSep_ = plantSeparation;
 
   includeForIgnition_ = includeForIgnition;
-}
 
-// average width, top, bottom, midheight computations for stratum
-
-/*!\brief Composition-weighted average of Species width
-  \return The composition-weighted average of Species width
-*/
-double Stratum::avWidth() const {
-  double av(0);
-  for(const auto& s : allSpecies_) av += s.composition() * s.crown().width();
-  return av;
+  computeDerived();
 }
 
-/*!\brief Composition-weighted average of Species height
-  \return The composition-weighted average of Species height
-*/
-double Stratum::avTop() const {
-  double av(0);
-  for(const auto& s : allSpecies_) av += s.composition() * s.crown().top();
-  return av;
-}
+/*!\brief Sets the dead leaf moisture of every constituent species
+  \param dead_leaf_moisture Proportion of oven dried weight
 
-/*!\brief Composition-weighted average of Species bottom
-  \return The composition-weighted average of the lowest coordinate
-  vertical coordinate of the Species crown
+  Only the average flame duration is recomputed, since the geometry of the 
+  Stratum does not depend on moisture.
 */
-double Stratum::avBottom() const {
-  double av(0);
-  for(const auto& s : allSpecies_) av += s.composition() * s.crown().bottom();
-  return av;
-}
-
-/*!\brief Composition-weighted average of Species mid-height
-  \return 0.5*(avTop() + avBottom())
-*/
-double Stratum::avMidHt() const {return 0.5*(avTop() + avBottom());}
-
-/*!\brief Composition-weighted average of Species flame duration
-  \return The composition-weighted average of Species flame duration
-*/
-double Stratum::avFlameDuration() const {
-  double av = 0;
-  for(const auto& s : allSpecies_) 
-    av += s.composition() * s.flameDuration();
-  return av;
+void Stratum::deadLeafMoisture(const double& dead_leaf_moisture) {
+  derived_.avFlameDuration = 0;
+  for(auto& s : allSpecies_) {
+    s.deadLeafMoisture(dead_leaf_moisture);
+    derived_.avFlameDuration += s.composition() * s.flameDuration();
+  }
 }
 
-// plant separation computation for stratum
+/*!\brief Computes the derived properties from the constituent species
 
-/*!\brief Maximum of plant separation and composition-weighted species width
-  \return The maximum of plantSep() and avWidth()
+  Called once before each constructor returns. The accessors avWidth(), avTop(),
+  avBottom(), avMidHt(), avFlameDuration(), modelPlantSep(), cover() and 
+  leafAreaIndex() return the values stored here.
 */
-double Stratum::modelPlantSep() const {
-  return (plantSep_ > avWidth()) ? plantSep_ : avWidth();
-}
+void Stratum::computeDerived() {
+  // composition-weighted averages of width, top, bottom and flame duration
+  derived_.avWidth = 0;
+  derived_.avTop = 0;
+  derived_.avBottom = 0;
+  derived_.avFlameDuration = 0;
+  for(const auto& s : allSpecies_) {
+    const Poly& crown = s.crown();
+    derived_.avWidth += s.composition() * crown.width();
+    derived_.avTop += s.composition() * crown.top();
+    derived_.avBottom += s.composition() * crown.bottom();
+    derived_.avFlameDuration += s.composition() * s.flameDuration();
+  }
 
-// cover computation for stratum
+  // plant separation, no less than the average width
+  derived_.modelPlantSep = (plantSep_ > derived_.avWidth) ? plantSep_ : derived_.avWidth;
 
-double Stratum::cover() const {
-  return pow(avWidth()/modelPlantSep(),2);
-}
+  // cover
+  derived_.cover = pow(derived_.avWidth/derived_.modelPlantSep,2);
 
-// leaf area index computation for stratum
-double Stratum::leafAreaIndex() const {
+  // leaf area index
   double lai(0);
   for(const auto& s : allSpecies_) lai += s.composition() * s.leafAreaIndex();
-  return lai * cover();
+  derived_.leafAreaIndex = lai * derived_.cover;
 }
-
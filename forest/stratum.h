@@ -34,10 +34,14 @@ public:
   //accessors
 
   LevelType level() const;
-  std::vector<Species> allSpecies() const;
+  const std::vector<Species>& allSpecies() const;
   double plantSep() const;
   bool includeForIgnition() const;
 
+  //mutators
+
+  void deadLeafMoisture(const double& deadLeafMoisture);
+
   //other methods
 
   double avWidth() const;
@@ -75,6 +79,27 @@ private:
   std::vector<Species> allSpecies_;
   double plantSep_;
   bool includeForIgnition_;
+
+  /*!\brief Composition-weighted quantities derived from the constituent species
+
+    The species and their compositions are fixed once the Stratum has been 
+    constructed, so these are computed once by computeDerived(). Only the average 
+    flame duration depends on the dead leaf moisture, and deadLeafMoisture() 
+    recomputes it.
+  */
+  struct DerivedProperties {
+    double avWidth = 0;
+    double avTop = 0;
+    double avBottom = 0;
+    double avFlameDuration = 0;
+    double modelPlantSep = 0;
+    double cover = 0;
+    double leafAreaIndex = 0;
+  };
+
+  DerivedProperties derived_;
+
+  void computeDerived();
 };
 
 
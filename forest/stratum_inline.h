@@ -6,7 +6,9 @@
 /*!\brief Default constructor produces empty Stratum*/
 inline Stratum::Stratum() : level_(Stratum::UNKNOWN_LEVEL),
 			    allSpecies_(std::vector<Species>()),
-			    plantSep_(-99) {}
+			    plantSep_(-99) {
+  computeDerived();
+}
 
 //accessors
 
@@ -18,7 +20,7 @@ inline Stratum::LevelType Stratum::level() const {return level_;}
 /*!\brief Constituent species
   \return A vector containing the Species objects comprising the Stratum
 */
-inline std::vector<Species> Stratum::allSpecies() const {
+inline const std::vector<Species>& Stratum::allSpecies() const {
   return allSpecies_;}
 
 /*!\brief Plant separation
@@ -28,6 +30,49 @@ inline double Stratum::plantSep() const {return plantSep_;}
 
 inline bool Stratum::includeForIgnition() const { return includeForIgnition_; }
 
+//other methods
+
+/*!\brief Composition-weighted average of Species width
+  \return The composition-weighted average of Species width
+*/
+inline double Stratum::avWidth() const {return derived_.avWidth;}
+
+/*!\brief Composition-weighted average of Species height
+  \return The composition-weighted average of Species height
+*/
+inline double Stratum::avTop() const {return derived_.avTop;}
+
+/*!\brief Composition-weighted average of Species bottom
+  \return The composition-weighted average of the lowest coordinate
+  vertical coordinate of the Species crown
+*/
+inline double Stratum::avBottom() const {return derived_.avBottom;}
+
+/*!\brief Composition-weighted average of Species mid-height
+  \return 0.5*(avTop() + avBottom())
+*/
+inline double Stratum::avMidHt() const {return 0.5*(derived_.avTop + derived_.avBottom);}
+
+/*!\brief Composition-weighted average of Species flame duration
+  \return The composition-weighted average of Species flame duration
+*/
+inline double Stratum::avFlameDuration() const {return derived_.avFlameDuration;}
+
+/*!\brief Maximum of plant separation and composition-weighted species width
+  \return The maximum of plantSep() and avWidth()
+*/
+inline double Stratum::modelPlantSep() const {return derived_.modelPlantSep;}
+
+/*!\brief Proportion of surface area covered by Stratum
+  \return The square of avWidth()/modelPlantSep()
+*/
+inline double Stratum::cover() const {return derived_.cover;}
+
+/*!\brief Leaf area index of Stratum
+  \return The composition-weighted Species leaf area index, scaled by cover()
+*/
+inline double Stratum::leafAreaIndex() const {return derived_.leafAreaIndex;}
+
 //operators
 
 /*!\brief Inequality
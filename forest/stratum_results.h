@@ -27,7 +27,7 @@ public:
   double flameLength() const;
   double flameAngle() const;
   double proportionBurnt() const;
-  std::map<std::string, double> speciesFlameTipHeights() const;
+  const std::map<std::string, double>& speciesFlameTipHeights() const;
 
   //mutators
 
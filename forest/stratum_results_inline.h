@@ -50,7 +50,7 @@ inline double StratumResults::flameAngle() const {return flameAngle_;}
 */
 inline double StratumResults::proportionBurnt() const {return proportionBurnt_;}
 
-inline std::map<std::string, double> StratumResults::speciesFlameTipHeights() const { return speciesFlameTipHeights_; }
+inline const std::map<std::string, double>& StratumResults::speciesFlameTipHeights() const { return speciesFlameTipHeights_; }
 
 
 //mutators
@@ -1,8 +1,17 @@
 #include <limits.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <set>
+#include <string_view>
+#include <thread>
 #include <utility>
+#include <sys/socket.h>
+#include <unistd.h>
 #include "pt.h"
 #include "species.h"
 #include "stratum.h"
@@ -12,6 +21,14 @@
 #include "layer.h"
 #include "ffm_settings.h"
 #include "ffm_util.h"
+#include "ffm_trace.h"
+#include "ffm_alloc.h"
+#include "scenario_file.h"
+#include "result_emitter.h"
+#include "pre_ignition_writer.h"
+#include "socket_server.h"
+#include "landscape.h"
+#include "emulator.h"
 
 using namespace ffm_settings;
 using std::vector;
@@ -19,33 +36,145 @@ using std::set;
 using std::cout;
 using std::endl;
 
-void process(std::string inPath, std::ostream &outputStream, bool paramsFlag, bool debugFlag) {
+// A slice of the Monte Carlo iterations, given by --shard index/count. When seeded
+// (--seed, implied by --shard) each iteration draws its inputs from a generator keyed
+// by the seed and the iteration number, so that an iteration gives the same result
+// whichever process computes it. A count of zero means the run is not sharded.
 
-  std::pair<Results::OutputLevelType, int> prelimPars = prelimParseInputTextFile(inPath);
+struct Shard {
+  int index = 0;
+  int count = 0;
+  bool seeded = false;
+  unsigned long long seed = 0;
+};
 
-  Results::OutputLevelType outputLevel = std::get<0>(prelimPars);
-  int numIter = std::get<1>(prelimPars);
+// Outputs summarised in the trailer of a shard, see process and merge
+const vector<std::pair<std::string, double (*)(const Results&)>> shardStatistics =
+  {{"ros_kmh", [](const Results& res) {return res.ros()*3.6;}},
+   {"flame_length_m", [](const Results& res) {return res.flameLength();}},
+   {"flame_tip_height_m", [](const Results& res) {return res.flameTipHeight();}}};
+
+// Adds the ignition path counters of the runs of res to those of totals, matching
+// runs by type
+
+void addCounters(const Results& res, vector<ForestIgnitionRun>& totals) {
+  for (const ForestIgnitionRun& run : res.runs()) {
+    auto it = std::find_if(totals.begin(), totals.end(),
+			   [&run](const ForestIgnitionRun& t) {return t.type() == run.type();});
+    if (it == totals.end())
+      it = totals.insert(totals.end(), ForestIgnitionRun(run.type(), Forest()));
+    for (int l = Stratum::SURFACE; l <= Stratum::CANOPY; l++) {
+      Stratum::LevelType level = static_cast<Stratum::LevelType>(l);
+      it->addCounters(level, run.counters(level));
+    }
+  }
+}
+
+void printCounters(const vector<ForestIgnitionRun>& totals, int numScenarios) {
+  if (!IgnitionCounters::ENABLED) {
+    cout << "Ignition path counters are not compiled in - build with make COUNTERS=1" << endl;
+    return;
+  }
+  cout << "Ignition path counters over " << numScenarios 
+       << (numScenarios == 1 ? " scenario" : " scenarios") << endl;
+  for (const ForestIgnitionRun& run : totals)
+    cout << run.printCountersToString();
+}
+
+// When emitter is not null results are written to it as structured records in place
+// of the text report or Monte Carlo CSV. With statsFlag or debugFlag the counts of
+// the work done computing ignition paths, summed over the scenarios, are written to
+// the console. When preIgnition is not null the pre-ignition data of every ignition
+// path is streamed to it
+
+void process(std::string inPath, std::ostream &outputStream, bool paramsFlag, bool debugFlag,
+	     bool statsFlag, ResultEmitter* emitter, const Shard& shard, 
+	     PreIgnitionWriter* preIgnition) {
+
+  // the file is read once, Monte Carlo iterations resample the same document
+  ffm_alloc::Phase parsePhase("parsing");
+  InputDocument doc = parseInputDocument(inPath);
+  parsePhase.end();
+
+  Results::OutputLevelType outputLevel = doc.outputLevel;
+  int numIter = doc.monteCarloIterations;
   
   bool monteCarlo = (outputLevel == Results::MONTE_CARLO);
+  SiteInputs inputs;
+  bool countersFlag = statsFlag || debugFlag;
+  vector<ForestIgnitionRun> counters;
+
+  // only the outputs that will be written are assembled, the counters are kept with
+  // the ignition runs and structured records hold the detailed outputs
+  Results::OutputLevelType resultsLevel = countersFlag ? Results::COMPREHENSIVE : 
+    emitter ? Results::DETAILED : outputLevel;
+
+  if (shard.count > 0 && !monteCarlo) {
+    cout << "Problem with input file - only Monte Carlo runs can be sharded" << endl;
+    exit(1);
+  }
   
   if (!monteCarlo) {
-    Location loc = parseInputTextFile(inPath, false);
+    ffm_alloc::Phase buildPhase("location building");
+    resolveSiteInputs(doc, false, inputs);
+    Location loc = buildLocation(inputs);
+    buildPhase.end();
 
     if (paramsFlag) 
       outputStream << loc.printToString() << endl;
     
-    Results res = loc.results();
+    if (preIgnition) {
+      preIgnition->site(inPath);
+      loc.preIgnitionObserver(preIgnition);
+    }
+    Results res = loc.results(resultsLevel);
 
-    outputStream << res.printToString(outputLevel) << endl;
+    if (emitter)
+      emitter->emit(res, inPath);
+    else
+      outputStream << res.printToString(outputLevel) << endl;
+
+    if (countersFlag) {
+      addCounters(res, counters);
+      printCounters(counters, 1);
+    }
   }
   else {
-    for (int i = 0; i < numIter; ) {
-      Location loc = parseInputTextFile(inPath, true);
+    // a sharded run writes its slice, between a line describing the slice and lines 
+    // holding mergeable statistics, each marked by a leading '#'
+    int first = 0, last = numIter;
+    if (shard.count > 0) {
+      first = static_cast<long long>(numIter)*shard.index/shard.count;
+      last = static_cast<long long>(numIter)*(shard.index + 1)/shard.count;
+      outputStream << "#shard," << shard.index << "," << shard.count << "," << first << "," 
+		   << last << "," << numIter << "," << shard.seed << endl;
+    }
+    vector<ffm_util::RunningStats> stats(shardStatistics.size());
+
+    bool newIteration = true;
+    for (int i = first; i < last; ) {
+      if (shard.seeded && newIteration) ffm_util::seedRandom(shard.seed, i);
+      ffm_alloc::Phase buildPhase("location building");
+      Location loc = resolveSiteInputs(doc, true, inputs) ? buildLocation(inputs) : Location();
+      buildPhase.end();
+      newIteration = !loc.empty();
 
       if (!loc.empty()) {
-        if (i == 0) outputStream << printMonteCarloHeader(loc);
+        if (preIgnition) {
+          preIgnition->site(inPath, i + 1);
+          loc.preIgnitionObserver(preIgnition);
+        }
+        Results res = loc.results(resultsLevel);
+        for (size_t k = 0; k < stats.size(); k++) stats[k].add(shardStatistics[k].second(res));
+        if (countersFlag) addCounters(res, counters);
+
+        if (emitter) {
+          emitter->emit(res, inPath, i + 1);
+          i++;
+          continue;
+        }
 
-        Results res = loc.results();
+        if (i == 0) outputStream << printMonteCarloHeader(loc);
 
         outputStream << printMonteCarloInputs(loc);
 
@@ -61,12 +190,526 @@ void process(std::string inPath, std::ostream &outputStream, bool paramsFlag, bo
         i++ ;
       }
     }
+
+    if (shard.count > 0) {
+      if (emitter) emitter->flush();
+      char buff[200];
+      for (size_t k = 0; k < stats.size(); k++) {
+	snprintf(buff, sizeof(buff), "#stats,%s,%ld,%.17g,%.17g,%.17g,%.17g", shardStatistics[k].first.c_str(),
+		 stats[k].count, stats[k].mean, stats[k].m2, stats[k].min, stats[k].max);
+	outputStream << buff << endl;
+      }
+    }
+
+    if (countersFlag) printCounters(counters, last - first);
   }
 
 }
 
-int main(int argc, char *argv[]) {
-  std::string usage("usage: ffm input_file [output_file] [-p] [-d]"); 
+void processScenario(std::string inPath, std::ostream &outputStream, bool paramsFlag,
+		     ResultEmitter* emitter, PreIgnitionWriter* preIgnition) {
+
+  ScenarioFile scenario(inPath);
+
+  for (size_t i = 0; i < scenario.numSites(); ++i) {
+    SiteInputs inputs = scenario.siteInputs(i);
+    Location loc = buildLocation(inputs);
+    if (preIgnition) {
+      preIgnition->site(scenario.siteName(i));
+      loc.preIgnitionObserver(preIgnition);
+    }
+
+    if (emitter) {
+      emitter->emit(loc.results(Results::DETAILED), scenario.siteName(i));
+      continue;
+    }
+
+    outputStream << "Site " << scenario.siteName(i) << endl;
+
+    if (paramsFlag) 
+      outputStream << loc.printToString() << endl;
+    
+    Results res = loc.results(inputs.outputLevel);
+
+    outputStream << res.printToString(inputs.outputLevel) << endl;
+  }
+}
+
+// Checks the inputs of one run of an override table or weather series, as
+// parseInputTextFile would, what names the run in the message
+
+void checkOverriddenInputs(const SiteInputs& in, const std::string& what) {
+  if (in.deadFuelMoistCont <= 0) {
+    cout << "Problem with " << what << " - surface dead fuel moisture content" << endl;
+    exit(1);
+  }
+  if (in.fuelLoad < 0.4) {
+    cout << "Problem with " << what << " - check fuel load tonnes per hectare" << endl;
+    exit(1);
+  }
+}
+
+// The location of one run of an override table or weather series. The forest of the
+// base inputs is built once by the caller, and only the dead fuel moisture content,
+// the one override that reaches the species, is re-derived in a copy of it. Every
+// other override only changes the surface, the weather or the location.
+
+Location overriddenLocation(const Forest& base, const SiteInputs& in) {
+  Forest forest = base;
+  forest.deadLeafMoisture(in.deadFuelMoistCont);
+  forest.surface(Surface(in.slope, in.deadFuelMoistCont, in.fuelLoad, 
+			 in.meanFuelDiameter, in.meanFinenessLeaves));
+  return Location(forest, Weather(in.airTemp), in.incidentWindSpeed, in.firelineLength);
+}
+
+void processOverrides(std::string inPath, std::string tablePath, std::ostream &outputStream,
+		      ResultEmitter* emitter) {
+
+  InputDocument doc = parseInputDocument(inPath);
+  if (doc.outputLevel == Results::MONTE_CARLO) {
+    cout << "Problem with input file - an override table cannot be used with Monte Carlo inputs" << endl;
+    exit(1);
+  }
+
+  SiteInputs base;
+  resolveSiteInputs(doc, false, base);
+  vector<SiteOverrides> rows = parseOverrideTable(tablePath);
+
+  // check every row before any computation, as parseInputTextFile would
+  vector<SiteInputs> rowInputs(rows.size(), base);
+  for (size_t i = 0; i < rows.size(); i++) {
+    rows[i].apply(rowInputs[i]);
+    checkOverriddenInputs(rowInputs[i], "override table row " + std::to_string(i + 1));
+  }
+
+  const Forest forest = buildLocation(base).forest();
+
+  for (size_t i = 0; i < rows.size(); i++) {
+    Location loc = overriddenLocation(forest, rowInputs[i]);
+
+    Results res = loc.results(emitter ? Results::DETAILED : Results::MONTE_CARLO);
+
+    if (emitter) {
+      emitter->emit(res, inPath, i + 1);
+      continue;
+    }
+
+    if (i == 0) outputStream << printOverrideHeader(loc);
+
+    outputStream << printOverrideInputs(i + 1, loc) << printMonteCarloResults(res) << endl;
+  }
+}
+
+// Weather series mode. The site is read once and run for each record of a weather
+// series, a CSV table with a time column and any of the columns of an override
+// table, typically incident wind speed, air temperature and surface dead fuel
+// moisture content. The forest is built once, with only its moisture dependent
+// properties re-derived for each record, and the records are computed on numWorkers
+// threads. One row is written per record, in the order of the
+// series, with the time stamp in place of the row number, or the time stamp as the
+// site of each structured record.
+
+void processWeatherSeries(std::string inPath, std::string seriesPath, std::ostream &outputStream,
+			  ResultEmitter* emitter, size_t numWorkers) {
+
+  InputDocument doc = parseInputDocument(inPath);
+  if (doc.outputLevel == Results::MONTE_CARLO) {
+    cout << "Problem with input file - a weather series cannot be used with Monte Carlo inputs" << endl;
+    exit(1);
+  }
+
+  SiteInputs base;
+  resolveSiteInputs(doc, false, base);
+  vector<std::string> times;
+  vector<SiteOverrides> records = parseOverrideTable(seriesPath, &times, "time");
+
+  vector<SiteInputs> hourInputs(records.size(), base);
+  for (size_t i = 0; i < records.size(); i++) {
+    records[i].apply(hourInputs[i]);
+    checkOverriddenInputs(hourInputs[i], "weather series row " + std::to_string(i + 1));
+  }
+
+  // the base forest is only read, and each record re-derives a copy of its own
+  const Forest forest = buildLocation(base).forest();
+  vector<Location> locs(records.size());
+  vector<Results> results(records.size());
+  std::atomic<size_t> next(0);
+  auto work = [&]() {
+    for (size_t i; (i = next++) < records.size(); ) {
+      locs[i] = overriddenLocation(forest, hourInputs[i]);
+      results[i] = locs[i].results(emitter ? Results::DETAILED : Results::MONTE_CARLO);
+    }
+  };
+
+  vector<std::thread> threads;
+  for (size_t t = 1; t < std::min(std::max<size_t>(numWorkers, 1), records.size()); ++t)
+    threads.emplace_back(work);
+  work();
+  for (std::thread& t : threads) t.join();
+
+  for (size_t i = 0; i < records.size(); i++) {
+    if (emitter) {
+      emitter->emit(results[i], times[i], i + 1);
+      continue;
+    }
+
+    if (i == 0) outputStream << printOverrideHeader(locs[i], "Time");
+
+    outputStream << printOverrideInputs(times[i], locs[i]) << printMonteCarloResults(results[i]) << endl;
+  }
+}
+
+// Worker mode. Scenario documents, each the text of an input file, are read from stdin
+// and a structured result record is written to stdout for each, in the order read, so
+// that a parent process may write many documents before reading any results. A document
+// is either
+//
+//   - a line holding only a byte count n, followed by n bytes of input file text, or
+//   - a single line of input file text with ';' in place of each line break.
+//
+// Blank lines between documents are ignored. Records carry the document number, from 1,
+// as their row. A document that cannot be computed gives an error record and the worker
+// carries on. A byte count that is unreadable or above MAX_DOCUMENT_LENGTH also gives an
+// error record, but ends the worker, since the document cannot be skipped. Output is
+// flushed whenever the worker is about to wait for more input.
+
+int serveStdio(ResultEmitter::FormatType format) {
+  std::ios::sync_with_stdio(false);
+  ResultEmitter emitter(cout, format);
+  std::string line, text, error;
+  Results res;
+  int request = 0;
+
+  while (true) {
+    if (std::cin.rdbuf()->in_avail() <= 0) emitter.flush();
+    if (!std::getline(std::cin, line)) break;
+    std::string_view trimmed = ffm_util::trimView(line, " \t\r");
+    if (trimmed.empty()) continue;
+    ++request;
+
+    if (trimmed.find_first_not_of("0123456789") == std::string_view::npos) {
+      size_t length = 0;
+      auto res = std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), length);
+      if (res.ec != std::errc() || length > MAX_DOCUMENT_LENGTH) {
+	emitter.emitError("Invalid document length", "stdin", request);
+	break;
+      }
+      text.resize(length);
+      if (!std::cin.read(&text[0], text.size())) {
+	emitter.emitError("Incomplete document", "stdin", request);
+	break;
+      }
+    }
+    else {
+      text.assign(trimmed);
+      std::replace(text.begin(), text.end(), ';', '\n');
+    }
+
+    if (scenarioResults(text, res, error))
+      emitter.emit(res, "stdin", request);
+    else
+      emitter.emitError(error, "stdin", request);
+  }
+
+  return 0;
+}
+
+// Local test client for the socket server. Each argument is sent in turn, "stats" as a
+// stats request and anything else as the contents of the input file it names, and every
+// response is copied to stdout. The responses to all the requests are awaited.
+
+int client(int argc, char *argv[]) {
+  std::string usage("usage: ffm client socket_file input_file|stats [input_file|stats ...]");
+
+  if (argc < 4) {
+    cout << usage << endl;
+    return 0;
+  }
+
+  int fd = SocketServer::connect(argv[2]);
+  if (fd < 0) {
+    cout << "Problem with socket - cannot connect (" << argv[2] << ")" << endl;
+    return 1;
+  }
+
+  // send from another thread, so that a server applying back-pressure cannot stall
+  // a client that has not yet started to read
+  std::thread sender([&]() {
+    for (int i = 3; i < argc; i++) {
+      std::string arg( argv[i] );
+      std::string msg = arg == "stats" ? std::string("stats\n") : readInputFile(arg);
+      if (arg != "stats") msg = std::to_string(msg.size()) + "\n" + msg;
+      for (std::string_view rest(msg); !rest.empty(); ) {
+	ssize_t n = send(fd, rest.data(), rest.size(), MSG_NOSIGNAL);
+	if (n <= 0) return;
+	rest.remove_prefix(n);
+      }
+    }
+    shutdown(fd, SHUT_WR);
+  });
+
+  char buff[1 << 16];
+  ssize_t n;
+  while ((n = recv(fd, buff, sizeof(buff), 0)) > 0)
+    cout.write(buff, n);
+  sender.join();
+  close(fd);
+  return 0;
+}
+
+int landscape(int argc, char *argv[]) {
+  std::string usage("usage: ffm landscape landscape_file output_prefix [--workers n]");
+
+  size_t numWorkers = std::max(1u, std::thread::hardware_concurrency());
+  vector<std::string> paths;
+  for (int i = 2; i < argc; i++) {
+    std::string arg( argv[i] );
+    if (arg == "--workers" && i + 1 < argc)
+      numWorkers = atoi(argv[++i]);
+    else
+      paths.push_back(arg);
+  }
+
+  if (paths.size() != 2) {
+    cout << usage << endl;
+    return 0;
+  }
+
+  Landscape land(paths[0]);
+  land.run(numWorkers);
+  land.write(paths[1]);
+  cout << "Computed " << land.numUnique() << " distinct cells of " << land.numCells();
+  if (land.numInvalid() > 0)
+    cout << ", " << land.numInvalid() << " with invalid inputs left as no data";
+  cout << endl;
+  return 0;
+}
+
+int emulate(int argc, char *argv[]) {
+  std::string usage("usage: ffm emulate input_file emulator_file [--wind min max] [--dfmc min max]\n"
+		    "                   [--tolerance x] [--max-points n] [--workers n]");
+
+  Emulator::Settings settings;
+  size_t numWorkers = std::max(1u, std::thread::hardware_concurrency());
+  vector<std::string> paths;
+  for (int i = 2; i < argc; i++) {
+    std::string arg( argv[i] );
+    if (arg == "--wind" && i + 2 < argc) {
+      settings.windMin = stringToDouble(argv[++i]);
+      settings.windMax = stringToDouble(argv[++i]);
+    }
+    else if (arg == "--dfmc" && i + 2 < argc) {
+      settings.dfmcMin = stringToDouble(argv[++i]);
+      settings.dfmcMax = stringToDouble(argv[++i]);
+    }
+    else if (arg == "--tolerance" && i + 1 < argc)
+      settings.tolerance = stringToDouble(argv[++i]);
+    else if (arg == "--max-points" && i + 1 < argc)
+      settings.maxPoints = atoi(argv[++i]);
+    else if (arg == "--workers" && i + 1 < argc)
+      numWorkers = atoi(argv[++i]);
+    else
+      paths.push_back(arg);
+  }
+
+  if (paths.size() != 2) {
+    cout << usage << endl;
+    return 0;
+  }
+
+  InputDocument doc = parseInputDocument(paths[0]);
+  if (doc.outputLevel == Results::MONTE_CARLO)
+    throw InputError("Problem with input file - an emulator cannot be built from Monte Carlo inputs");
+  SiteInputs inputs;
+  resolveSiteInputs(doc, false, inputs);
+
+  Emulator emulator(inputs, settings, numWorkers);
+  emulator.write(paths[1]);
+
+  // time queries spread over the whole grid
+  const int numQueries = 1000000;
+  Emulator::Outputs out;
+  volatile double sink = 0; //keeps the queries from being optimised away
+  auto start = std::chrono::steady_clock::now();
+  for (int q = 0; q < numQueries; q++) {
+    double f = (q % 1000)/999.0, g = (q/1000)/999.0;
+    emulator.query(settings.windMin + f*(settings.windMax - settings.windMin),
+		   settings.dfmcMin + g*(settings.dfmcMax - settings.dfmcMin), out);
+    sink = sink + out[Emulator::ROS];
+  }
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+  cout << "Built a " << emulator.numWindSpeeds() << " x " << emulator.numMoistureContents()
+       << " grid from " << emulator.numModelRuns() << " model runs" << endl;
+  cout << "Maximum error " << emulator.maxError(Emulator::ROS) << " km/h rate of spread, "
+       << emulator.maxError(Emulator::FLAME_HEIGHT) << " m flame height" << endl;
+  cout << "Query time " << elapsed.count()/numQueries << " ns (checksum " << sink << ")" << endl;
+  return 0;
+}
+
+int query(int argc, char *argv[]) {
+  std::string usage("usage: ffm query emulator_file wind_speed dfmc [wind_speed dfmc ...]");
+
+  if (argc < 5 || (argc - 3) % 2 != 0) {
+    cout << usage << endl;
+    return 0;
+  }
+
+  Emulator emulator(argv[2]);
+  cout << "Wind speed (km/h),Dead FMC,ROS (km/h),Flame height (m)" << endl;
+  Emulator::Outputs out;
+  for (int i = 3; i + 1 < argc; i += 2) {
+    double w = stringToDouble(argv[i]), d = stringToDouble(argv[i + 1]);
+    cout << argv[i] << "," << argv[i + 1] << ",";
+    if (emulator.query(w, d, out))
+      cout << out[Emulator::ROS] << "," << out[Emulator::FLAME_HEIGHT] << endl;
+    else
+      cout << "outside the emulator," << endl;
+  }
+  return 0;
+}
+
+// Combines the outputs of the shards of a Monte Carlo run. The rows of the shards are
+// written in order, without the shard lines, which gives exactly the output of the
+// same run in a single process with the same seed, and the statistics of the shards
+// are merged and reported.
+
+int merge(int argc, char *argv[]) {
+  std::string usage("usage: ffm merge output_file shard_file [shard_file ...]");
+
+  if (argc < 4) {
+    cout << usage << endl;
+    return 0;
+  }
+
+  struct ShardOutput {
+    std::string path;
+    std::string contents;
+    int index, count, first, last, numIter;
+    unsigned long long seed;
+  };
+  vector<ShardOutput> shards;
+  for (int i = 3; i < argc; i++) {
+    ShardOutput sh;
+    sh.path = argv[i];
+    sh.contents = readInputFile(sh.path);
+    if (sscanf(sh.contents.c_str(), "#shard,%d,%d,%d,%d,%d,%llu", &sh.index, &sh.count, 
+	       &sh.first, &sh.last, &sh.numIter, &sh.seed) != 6)
+      throw InputError("Problem with shard file - " + sh.path + " is not the output of a sharded run");
+    shards.push_back(std::move(sh));
+  }
+
+  std::sort(shards.begin(), shards.end(), 
+	    [](const ShardOutput& a, const ShardOutput& b) {return a.index < b.index;});
+  for (size_t i = 0; i < shards.size(); i++) {
+    const ShardOutput& sh = shards[i];
+    if (sh.count != static_cast<int>(shards.size()) || sh.index != static_cast<int>(i))
+      throw InputError("Problem with shard files - expected shards 0 to " + std::to_string(shards.size() - 1) +
+		       " of " + std::to_string(shards.size()) + ", found " + sh.path + 
+		       " (shard " + std::to_string(sh.index) + " of " + std::to_string(sh.count) + ")");
+    if (sh.seed != shards[0].seed || sh.numIter != shards[0].numIter || 
+	sh.first != (i == 0 ? 0 : shards[i - 1].last) || 
+	(i + 1 == shards.size() && sh.last != sh.numIter))
+      throw InputError("Problem with shard files - " + sh.path + " is not from the same run as " + shards[0].path);
+  }
+
+  std::ofstream fout(argv[2], std::ios::binary);
+  vector<ffm_util::RunningStats> stats(shardStatistics.size());
+  for (const ShardOutput& sh : shards) {
+    std::string_view rest(sh.contents), line;
+    bool complete = false;
+    while (!rest.empty()) {
+      size_t end = rest.find('\n');
+      line = rest.substr(0, end == std::string_view::npos ? rest.size() : end + 1);
+      rest.remove_prefix(line.size());
+      if (line.substr(0, 7) == "#stats,") {
+	ffm_util::RunningStats st;
+	char name[64];
+	std::string text(line);
+	if (sscanf(text.c_str(), "#stats,%63[^,],%ld,%lf,%lf,%lf,%lf", name, &st.count, &st.mean,
+		   &st.m2, &st.min, &st.max) != 6)
+	  throw InputError("Problem with shard file - invalid statistics in " + sh.path);
+	for (size_t k = 0; k < stats.size(); k++) {
+	  if (shardStatistics[k].first != name) continue;
+	  stats[k].merge(st);
+	  complete = complete || k + 1 == stats.size();
+	}
+      }
+      else if (line[0] != '#')
+	fout << line;
+    }
+    if (!complete)
+      throw InputError("Problem with shard file - " + sh.path + " is incomplete");
+  }
+  fout.close();
+  if (!fout) {
+    cout << "Problem writing " << argv[2] << endl;
+    return 1;
+  }
+
+  cout << "Merged " << shards.size() << " shards of " << shards[0].numIter << " iterations into " 
+       << argv[2] << endl;
+  cout << "Output,Count,Mean,Std dev,Min,Max" << endl;
+  for (size_t k = 0; k < stats.size(); k++)
+    cout << shardStatistics[k].first << "," << stats[k].count << "," << stats[k].mean << "," 
+	 << stats[k].stdDev() << "," << stats[k].min << "," << stats[k].max << endl;
+  return 0;
+}
+
+int compile(int argc, char *argv[]) {
+  std::string usage("usage: ffm compile scenario_file input_file [input_file ...] [--verify]");
+
+  bool verifyFlag = false;
+  std::string outPath;
+  vector<std::string> inPaths;
+  for (int i = 2; i < argc; i++) {
+    std::string arg( argv[i] );
+    if (arg == "--verify")
+      verifyFlag = true;
+    else if (outPath.empty())
+      outPath = arg;
+    else
+      inPaths.push_back(arg);
+  }
+
+  if (inPaths.empty()) {
+    cout << usage << endl;
+    return 0;
+  }
+
+  vector<SiteInputs> sites(inPaths.size());
+  for (size_t i = 0; i < inPaths.size(); i++) {
+    InputDocument doc = parseInputDocument(inPaths[i]);
+    if (doc.outputLevel == Results::MONTE_CARLO) {
+      cout << "Problem with input file - Monte Carlo inputs cannot be compiled (" << inPaths[i] << ")" << endl;
+      return 1;
+    }
+    resolveSiteInputs(doc, false, sites[i]);
+  }
+
+  ScenarioFile::write(outPath, inPaths, sites);
+  cout << "Compiled " << sites.size() << " sites into " << outPath << endl;
+
+  // round trip check: the compiled sites must reproduce the text inputs exactly
+  if (verifyFlag) {
+    ScenarioFile scenario(outPath);
+    bool okay = scenario.numSites() == inPaths.size();
+    for (size_t i = 0; okay && i < inPaths.size(); i++) {
+      if (scenario.siteName(i) != inPaths[i] ||
+	  !(scenario.siteInputs(i) == sites[i]) ||
+	  scenario.location(i).printToString() != parseInputTextFile(inPaths[i], false).printToString()) {
+	cout << "Round trip check failed for " << inPaths[i] << endl;
+	okay = false;
+      }
+    }
+    if (!okay) return 1;
+    cout << "Verified " << scenario.numSites() << " sites" << endl;
+  }
+
+  return 0;
+}
+
+int run(int argc, char *argv[], const std::string& usage) {
 
   if (argc < 2) {
     cout << usage << endl;
@@ -76,15 +719,67 @@ int main(int argc, char *argv[]) {
   // collect the inPath and the optional outPath and flag arguments
   bool paramsFlag = false;
   bool debugFlag = false;
+  bool statsFlag = false;
+  bool memoryFlag = false;
   std::string params_flag_str("-p");
   std::string debug_flag_str("-d");
   std::string inPath;
   std::string outPath;
+  std::string tablePath;
+  std::string seriesPath;
+  std::string tracePath;
+  std::string preIgnitionPath;
+  bool serveFlag = false;
+  std::string socketPath;
+  size_t numWorkers = std::max(1u, std::thread::hardware_concurrency());
+  size_t queueCapacity = 0;
+  bool formatFlag = false;
+  ResultEmitter::FormatType format = ResultEmitter::NDJSON;
+  Shard shard;
 
   for (int i = 1; i < argc; i++) {
     std::string arg( argv[i] );
 
-    if (arg.compare(0, params_flag_str.size(), params_flag_str) == 0)
+    if (arg == "--serve-stdio")
+      serveFlag = true;
+    else if (arg == "--serve-socket" && i + 1 < argc)
+      socketPath = argv[++i];
+    else if (arg == "--workers" && i + 1 < argc)
+      numWorkers = atoi(argv[++i]);
+    else if (arg == "--queue" && i + 1 < argc)
+      queueCapacity = atoi(argv[++i]);
+    else if (arg == "--overrides" && i + 1 < argc)
+      tablePath = argv[++i];
+    else if (arg == "--shard" && i + 1 < argc) {
+      if (sscanf(argv[++i], "%d/%d", &shard.index, &shard.count) != 2 ||
+	  shard.count < 1 || shard.index < 0 || shard.index >= shard.count) {
+	cout << usage << endl;
+	return 0;
+      }
+      shard.seeded = true;
+    }
+    else if (arg == "--seed" && i + 1 < argc) {
+      shard.seed = std::strtoull(argv[++i], nullptr, 10);
+      shard.seeded = true;
+    }
+    else if (arg == "--stats")
+      statsFlag = true;
+    else if (arg == "--memory")
+      memoryFlag = true;
+    else if (arg == "--trace" && i + 1 < argc)
+      tracePath = argv[++i];
+    else if (arg == "--pre-ignition" && i + 1 < argc)
+      preIgnitionPath = argv[++i];
+    else if (arg == "--weather" && i + 1 < argc)
+      seriesPath = argv[++i];
+    else if (arg == "--format" && i + 1 < argc) {
+      formatFlag = true;
+      if (!ResultEmitter::formatType(argv[++i], format)) {
+	cout << usage << endl;
+	return 0;
+      }
+    }
+    else if (arg.compare(0, params_flag_str.size(), params_flag_str) == 0)
       paramsFlag = true;
     else if (arg.compare(0, debug_flag_str.size(), debug_flag_str) == 0)
       debugFlag = true;
@@ -94,7 +789,16 @@ int main(int argc, char *argv[]) {
       outPath = arg;
   }
 
-  if (inPath.empty()) {
+  if (serveFlag)
+    return serveStdio(format);
+
+  if (!socketPath.empty()) {
+    SocketServer server(socketPath, numWorkers, queueCapacity > 0 ? queueCapacity : 4*numWorkers);
+    server.run();
+    return 1;
+  }
+
+  if (inPath.empty() || (shard.count > 0 && formatFlag && format == ResultEmitter::CSV)) {
     cout << usage << endl;
     return 0;
   }
@@ -106,9 +810,82 @@ int main(int argc, char *argv[]) {
     fp = &fout;
   }
 
-  process(inPath, *fp, paramsFlag, debugFlag);
+  if (!tracePath.empty()) ffm_trace::enable();
+
+  std::ofstream preIgnitionOut;
+  std::unique_ptr<PreIgnitionWriter> preIgnition;
+  if (!preIgnitionPath.empty()) {
+    preIgnitionOut.open(preIgnitionPath);
+    if (!preIgnitionOut) {
+      cout << "Problem opening pre-ignition file " << preIgnitionPath << endl;
+      return 1;
+    }
+    preIgnition.reset(new PreIgnitionWriter(preIgnitionOut));
+  }
+
+  {
+    std::unique_ptr<ResultEmitter> emitter;
+    if (formatFlag) emitter.reset(new ResultEmitter(*fp, format));
+
+    if (!tablePath.empty())
+      processOverrides(inPath, tablePath, *fp, emitter.get());
+    else if (!seriesPath.empty())
+      processWeatherSeries(inPath, seriesPath, *fp, emitter.get(), numWorkers);
+    else if (ScenarioFile::isScenarioFile(inPath))
+      processScenario(inPath, *fp, paramsFlag, emitter.get(), preIgnition.get());
+    else
+      process(inPath, *fp, paramsFlag, debugFlag, statsFlag, emitter.get(), shard, preIgnition.get());
+  } //the emitter flushes on destruction
   if (!outPath.empty()) fout.close();
 
+  if (!tracePath.empty() && !ffm_trace::write(tracePath)) {
+    cout << "Problem writing trace file " << tracePath << endl;
+    return 1;
+  }
+
+  if (memoryFlag) {
+    if (ffm_alloc::ENABLED)
+      cout << "Allocations by phase" << endl << ffm_alloc::report();
+    else
+      cout << "Allocation tracking is not compiled in - build with make ALLOC_TRACKING=1" << endl;
+  }
+
   return 0;
 }
 
+int main(int argc, char *argv[]) {
+  std::string usage("usage: ffm input_file [output_file] [-p] [-d] [--stats] [--memory]\n"
+		    "                                    [--trace trace_file] [--pre-ignition csv_file]\n"
+		    "                                    [--overrides table_file] [--format ndjson|csv]\n"
+		    "       ffm input_file [output_file] [--seed s] [--shard i/n] [--format ndjson]\n"
+		    "       ffm input_file [output_file] --weather series_file [--workers n] [--format ndjson|csv]\n"
+		    "       ffm merge output_file shard_file [shard_file ...]\n"
+		    "       ffm compile scenario_file input_file [input_file ...] [--verify]\n"
+		    "       ffm --serve-stdio [--format ndjson|csv]\n"
+		    "       ffm --serve-socket socket_file [--workers n] [--queue n]\n"
+		    "       ffm client socket_file input_file|stats [input_file|stats ...]\n"
+		    "       ffm landscape landscape_file output_prefix [--workers n]\n"
+		    "       ffm emulate input_file emulator_file [--wind min max] [--dfmc min max]\n"
+		    "                   [--tolerance x] [--max-points n] [--workers n]\n"
+		    "       ffm query emulator_file wind_speed dfmc [wind_speed dfmc ...]"); 
+
+  try {
+    if (argc > 1 && std::string(argv[1]) == "compile")
+      return compile(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "merge")
+      return merge(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "client")
+      return client(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "landscape")
+      return landscape(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "emulate")
+      return emulate(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "query")
+      return query(argc, argv);
+    return run(argc, argv, usage);
+  }
+  catch (const InputError& e) {
+    cout << e.what() << endl;
+    return 1;
+  }
+}
@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <thread>
+
+#include "emulator.h"
+#include "ffm_io.h"
+#include "location.h"
+
+namespace {
+
+  const char MAGIC[8] = {'F','F','M','E','M','U','L','\0'};
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  template<typename T> void put(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template<typename T> T get(const std::string& buffer, size_t& pos, const std::string& path) {
+    if (buffer.size() - pos < sizeof(T))
+      throw InputError("Problem with emulator file - " + path + " is truncated or corrupt");
+    T value;
+    memcpy(&value, buffer.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+  }
+
+  /*!\brief An axis of n evenly spaced values from min to max*/
+  std::vector<double> evenAxis(const double& min, const double& max, const size_t& n) {
+    std::vector<double> axis(n);
+    for (size_t k = 0; k < n; ++k) axis[k] = min + (max - min)*k/(n - 1);
+    axis.back() = max;
+    return axis;
+  }
+
+}
+
+/*!\brief Builds an emulator by running the model
+  \param site The inputs of the site, whose wind speed and dead fuel moisture content
+  are replaced at each point
+  \param settings
+  \param numWorkers The number of threads on which the model is run
+
+  An InputError is thrown if the ranges of settings are empty or the site inputs
+  would be rejected by the input file parser.
+*/
+Emulator::Emulator(const SiteInputs& site, const Settings& settings, const size_t& numWorkers) {
+  if (!(settings.windMin >= 0 && settings.windMax > settings.windMin &&
+	settings.dfmcMin > 0 && settings.dfmcMax > settings.dfmcMin))
+    throw InputError("Problem with emulator - wind speed and moisture content ranges must be increasing, "
+		     "with positive moisture content");
+  SiteInputs corner = site;
+  SiteOverrides overrides;
+  overrides.incidentWindSpeed = settings.windMin;
+  overrides.deadFuelMoistCont = settings.dfmcMin;
+  overrides.apply(corner);
+  if (!checkSiteInputs(corner))
+    throw InputError("Problem with emulator - the site inputs are invalid");
+
+  const size_t n0 = std::max<size_t>(settings.initialPoints, 2);
+  const size_t maxPoints = std::max(settings.maxPoints, n0);
+  wind_ = evenAxis(settings.windMin, settings.windMax, n0);
+  dfmc_ = evenAxis(settings.dfmcMin, settings.dfmcMax, n0);
+  const double scale = std::ldexp(1.0, -std::max(settings.maxDepth, 0))/(n0 - 1);
+  const std::array<double, 2> minWidth = {(settings.windMax - settings.windMin)*scale,
+					  (settings.dfmcMax - settings.dfmcMin)*scale};
+
+  Cache cache;
+  std::vector<std::pair<double, double>> points;
+  for (double w : wind_)
+    for (double d : dfmc_)
+      points.emplace_back(w, d);
+  run(site, points, cache, numWorkers);
+
+  //outputs are compared relative to their magnitude, but not below 1% of the largest value
+  Outputs floor = {};
+  for (const auto& entry : cache)
+    for (int k = 0; k < NUM_OUTPUTS; ++k)
+      floor[k] = std::max(floor[k], 0.01*std::fabs(entry.second[k]));
+  auto relativeError = [&floor](const Outputs& model, const Outputs& lower, const Outputs& upper) {
+    double err = 0;
+    for (int k = 0; k < NUM_OUTPUTS; ++k) {
+      double denom = std::max(std::fabs(model[k]), floor[k]);
+      if (denom > 0) err = std::max(err, std::fabs(model[k] - 0.5*(lower[k] + upper[k]))/denom);
+    }
+    return err;
+  };
+
+  //split intervals of each axis in turn until none needs it
+  for (bool split = true; split; ) {
+    split = false;
+    for (int axis = 0; axis < 2; ++axis) {
+      std::vector<double>& ax = axis == 0 ? wind_ : dfmc_;
+      const std::vector<double>& other = axis == 0 ? dfmc_ : wind_;
+      if (ax.size() >= maxPoints) continue;
+      auto point = [axis](const double& a, const double& o) {
+	return axis == 0 ? std::make_pair(a, o) : std::make_pair(o, a);
+      };
+
+      std::vector<size_t> candidates;
+      points.clear();
+      for (size_t k = 0; k + 1 < ax.size(); ++k) {
+	if (0.5*(ax[k + 1] - ax[k]) < minWidth[axis]*(1 - 1e-9)) continue;
+	candidates.push_back(k);
+	for (double o : other) points.push_back(point(0.5*(ax[k] + ax[k + 1]), o));
+      }
+      run(site, points, cache, numWorkers);
+
+      std::vector<std::pair<double, double>> splits; //error and midpoint
+      for (size_t k : candidates) {
+	double mid = 0.5*(ax[k] + ax[k + 1]);
+	double err = 0;
+	for (double o : other)
+	  err = std::max(err, relativeError(cache.at(point(mid, o)), cache.at(point(ax[k], o)),
+					    cache.at(point(ax[k + 1], o))));
+	if (err > settings.tolerance) splits.emplace_back(err, mid);
+      }
+      if (splits.empty()) continue;
+
+      std::sort(splits.begin(), splits.end(), std::greater<std::pair<double, double>>());
+      splits.resize(std::min(splits.size(), maxPoints - ax.size()));
+      for (const auto& s : splits) ax.push_back(s.second);
+      std::sort(ax.begin(), ax.end());
+      split = true;
+    }
+  }
+
+  table_.reserve(wind_.size()*dfmc_.size());
+  for (double w : wind_)
+    for (double d : dfmc_)
+      table_.push_back(cache.at(std::make_pair(w, d)));
+
+  //check against the model at the cell centres
+  points.clear();
+  for (size_t i = 0; i + 1 < wind_.size(); ++i)
+    for (size_t j = 0; j + 1 < dfmc_.size(); ++j)
+      points.emplace_back(0.5*(wind_[i] + wind_[i + 1]), 0.5*(dfmc_[j] + dfmc_[j + 1]));
+  run(site, points, cache, numWorkers);
+  Outputs interp;
+  for (const auto& p : points) {
+    query(p.first, p.second, interp);
+    const Outputs& exact = cache.at(p);
+    for (int k = 0; k < NUM_OUTPUTS; ++k)
+      maxError_[k] = std::max(maxError_[k], std::fabs(interp[k] - exact[k]));
+  }
+  numModelRuns_ = cache.size();
+}
+
+/*!\brief Reads an emulator file
+  \param path
+
+  An InputError is thrown if the file cannot be read, is not an emulator file or
+  has a version or byte order other than those written by this program.
+*/
+Emulator::Emulator(const std::string& path) {
+  std::ifstream inFile(path, std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+  if (buffer.size() < sizeof(MAGIC) || memcmp(buffer.data(), MAGIC, sizeof(MAGIC)) != 0)
+    throw InputError("Problem with emulator file - " + path + " is not an emulator file");
+
+  size_t pos = sizeof(MAGIC);
+  uint32_t version = get<uint32_t>(buffer, pos, path);
+  uint32_t byteOrder = get<uint32_t>(buffer, pos, path);
+  if (version != VERSION || byteOrder != BYTE_ORDER_MARK)
+    throw InputError("Problem with emulator file - " + path + " has version " + std::to_string(version) +
+		     " or byte order unsupported by this program");
+
+  wind_.resize(get<uint32_t>(buffer, pos, path));
+  dfmc_.resize(get<uint32_t>(buffer, pos, path));
+  if (wind_.size() < 2 || dfmc_.size() < 2 ||
+      buffer.size() - pos != (wind_.size() + dfmc_.size() + wind_.size()*dfmc_.size()*NUM_OUTPUTS +
+			      NUM_OUTPUTS)*sizeof(double) + sizeof(uint64_t))
+    throw InputError("Problem with emulator file - " + path + " is truncated or corrupt");
+
+  for (double& w : wind_) w = get<double>(buffer, pos, path);
+  for (double& d : dfmc_) d = get<double>(buffer, pos, path);
+  table_.resize(wind_.size()*dfmc_.size());
+  for (Outputs& out : table_)
+    for (double& v : out) v = get<double>(buffer, pos, path);
+  for (double& e : maxError_) e = get<double>(buffer, pos, path);
+  numModelRuns_ = get<uint64_t>(buffer, pos, path);
+
+  if (!std::is_sorted(wind_.begin(), wind_.end()) || !std::is_sorted(dfmc_.begin(), dfmc_.end()))
+    throw InputError("Problem with emulator file - " + path + " is truncated or corrupt");
+}
+
+/*!\brief Writes an emulator file, see the class description for the layout
+  \param path
+*/
+void Emulator::write(const std::string& path) const {
+  std::string buffer(MAGIC, sizeof(MAGIC));
+  put(buffer, VERSION);
+  put(buffer, BYTE_ORDER_MARK);
+  put(buffer, static_cast<uint32_t>(wind_.size()));
+  put(buffer, static_cast<uint32_t>(dfmc_.size()));
+  for (double w : wind_) put(buffer, w);
+  for (double d : dfmc_) put(buffer, d);
+  for (const Outputs& out : table_)
+    for (double v : out) put(buffer, v);
+  for (double e : maxError_) put(buffer, e);
+  put(buffer, static_cast<uint64_t>(numModelRuns_));
+
+  std::ofstream outFile(path, std::ios::binary);
+  outFile.write(buffer.data(), buffer.size());
+  if (!outFile)
+    throw InputError("Problem writing emulator file " + path);
+}
+
+/*!\brief Runs the full model
+  \param site
+  \param windSpeed Incident wind speed (km/h)
+  \param deadFuelMoistCont Surface dead fuel moisture content (fraction)
+  \return The rate of spread (km/h) and flame height (m), as held by an emulator
+*/
+Emulator::Outputs Emulator::model(const SiteInputs& site, const double& windSpeed,
+				  const double& deadFuelMoistCont) {
+  SiteInputs inputs = site;
+  SiteOverrides overrides;
+  overrides.incidentWindSpeed = windSpeed;
+  overrides.deadFuelMoistCont = deadFuelMoistCont;
+  overrides.apply(inputs);
+  Results res = buildLocation(inputs).results(Results::BASIC);
+  return {res.ros()*3.6, res.flameTipHeight()};
+}
+
+/*!\brief Runs the model at those of points that are not already in cache, and adds them*/
+void Emulator::run(const SiteInputs& site, const std::vector<std::pair<double, double>>& points,
+		   Cache& cache, const size_t& numWorkers) {
+  std::vector<std::pair<double, double>> todo;
+  for (const auto& p : points)
+    if (cache.find(p) == cache.end()) todo.push_back(p);
+  std::sort(todo.begin(), todo.end());
+  todo.erase(std::unique(todo.begin(), todo.end()), todo.end());
+
+  std::vector<Outputs> outputs(todo.size());
+  std::atomic<size_t> next(0);
+  auto work = [&]() {
+    for (size_t i; (i = next++) < todo.size(); )
+      outputs[i] = model(site, todo[i].first, todo[i].second);
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < std::min(std::max<size_t>(numWorkers, 1), todo.size()); ++t)
+    threads.emplace_back(work);
+  work();
+  for (std::thread& t : threads) t.join();
+
+  for (size_t i = 0; i < todo.size(); ++i) cache.emplace(todo[i], outputs[i]);
+}
@@ -0,0 +1,102 @@
+#ifndef EMULATOR_H
+#define EMULATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "site_inputs.h"
+
+/*!\brief A response surface for one site, giving rate of spread and flame height as
+  functions of incident wind speed and surface dead fuel moisture content.
+
+  The surface is a table of model outputs on a rectangular grid, whose wind speeds and
+  moisture contents need not be evenly spaced, and is queried by bilinear interpolation.
+  The grid is built adaptively: starting from an even grid, the midpoint of each
+  interval of either axis is computed with the full model wherever the interval is
+  wider than the minimum, and the midpoint is added to the axis if the interpolated
+  outputs there differ from the model by more than the tolerance. This repeats until
+  no interval is split, so the grid is fine where the outputs change sharply, for
+  example about the onset of crown fire, and coarse elsewhere. An output is compared
+  relative to the larger of its magnitude and 1% of its largest value on the initial
+  grid, so that small values are not chased.
+
+  Once built, the model is run again at the centre of every cell of the grid, the
+  points furthest from any computed value, and the largest absolute difference from
+  the interpolated outputs is recorded for each output. Where an output is
+  discontinuous the error stays large however fine the grid, and is reported as such.
+
+  Emulator files hold the axes, the table and the recorded errors in binary form.
+
+  Layout (version 1):
+    header   magic "FFMEMUL", uint32 version, uint32 byte order mark,
+             uint32 number of wind speeds, uint32 number of moisture contents
+    axes     the wind speeds (km/h) then the moisture contents, as doubles
+    table    for each wind speed, for each moisture content, the rate of spread
+             (km/h) then the flame height (m), as doubles
+    errors   the maximum error of each output, then the number of model runs, as
+             uint64
+*/
+class Emulator {
+public:
+
+  static constexpr uint32_t VERSION = 1;
+
+  /*!\brief The outputs held in the table*/
+  enum OutputType {ROS, FLAME_HEIGHT, NUM_OUTPUTS};
+
+  typedef std::array<double, NUM_OUTPUTS> Outputs;
+
+  /*!\brief The region covered and the accuracy sought when building*/
+  struct Settings {
+    double windMin = 0;            //!< km/h
+    double windMax = 60;           //!< km/h
+    double dfmcMin = 0.03;         //!< fraction, must be positive
+    double dfmcMax = 0.25;         //!< fraction
+    size_t initialPoints = 5;      //!< points on each axis of the initial grid, at least 2
+    size_t maxPoints = 33;         //!< points on each axis are not split beyond this
+    double tolerance = 0.05;       //!< relative error at which an interval is split
+    int maxDepth = 8;              //!< an interval is never narrower than 2^-maxDepth of the initial ones
+  };
+
+  //constructors
+
+  Emulator(const SiteInputs& site, const Settings& settings, const size_t& numWorkers);
+  explicit Emulator(const std::string& path);
+
+  //accessors
+
+  size_t numWindSpeeds() const;
+  size_t numMoistureContents() const;
+  double maxError(const OutputType& output) const;
+  unsigned long numModelRuns() const;
+
+  //other methods
+
+  bool query(const double& windSpeed, const double& deadFuelMoistCont, Outputs& outputs) const;
+  void write(const std::string& path) const;
+
+  static Outputs model(const SiteInputs& site, const double& windSpeed, const double& deadFuelMoistCont);
+
+private:
+
+  std::vector<double> wind_;
+  std::vector<double> dfmc_;
+  std::vector<Outputs> table_;  //wind speed major
+  Outputs maxError_ = {};
+  unsigned long numModelRuns_ = 0;
+
+  //model outputs computed while building, by wind speed and moisture content
+  typedef std::map<std::pair<double, double>, Outputs> Cache;
+
+  const Outputs& at(const size_t& i, const size_t& j) const;
+  void run(const SiteInputs& site, const std::vector<std::pair<double, double>>& points,
+	   Cache& cache, const size_t& numWorkers);
+};
+
+#include "emulator_inline.h"
+
+#endif //EMULATOR_H
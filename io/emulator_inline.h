@@ -0,0 +1,55 @@
+#ifndef EMULATOR_INLINE_H
+#define EMULATOR_INLINE_H
+
+#include <algorithm>
+
+/*!\brief Number of wind speeds in the grid*/
+inline size_t Emulator::numWindSpeeds() const {return wind_.size();}
+
+/*!\brief Number of dead fuel moisture contents in the grid*/
+inline size_t Emulator::numMoistureContents() const {return dfmc_.size();}
+
+/*!\brief The largest difference from the model found at the cell centres
+  \param output
+  \return The error in the units of the output, km/h or m
+*/
+inline double Emulator::maxError(const OutputType& output) const {return maxError_[output];}
+
+/*!\brief The number of times the model was run to build and check the emulator*/
+inline unsigned long Emulator::numModelRuns() const {return numModelRuns_;}
+
+/*!\brief The table entry at wind speed i and moisture content j*/
+inline const Emulator::Outputs& Emulator::at(const size_t& i, const size_t& j) const {
+  return table_[i*dfmc_.size() + j];
+}
+
+/*!\brief Interpolated outputs
+  \param windSpeed Incident wind speed (km/h)
+  \param deadFuelMoistCont Surface dead fuel moisture content (fraction)
+  \param outputs Set to the rate of spread (km/h) and flame height (m)
+  \return False, leaving outputs unchanged, if the point is outside the grid
+*/
+inline bool Emulator::query(const double& windSpeed, const double& deadFuelMoistCont,
+			    Outputs& outputs) const {
+  if (!(windSpeed >= wind_.front() && windSpeed <= wind_.back() &&
+	deadFuelMoistCont >= dfmc_.front() && deadFuelMoistCont <= dfmc_.back()))
+    return false;
+
+  //index of the lower corner of the cell, the last cell holds the upper edges
+  size_t i = std::min<size_t>(std::upper_bound(wind_.begin(), wind_.end(), windSpeed) - wind_.begin(),
+			      wind_.size() - 1) - 1;
+  size_t j = std::min<size_t>(std::upper_bound(dfmc_.begin(), dfmc_.end(), deadFuelMoistCont) - dfmc_.begin(),
+			      dfmc_.size() - 1) - 1;
+  double u = (windSpeed - wind_[i])/(wind_[i + 1] - wind_[i]);
+  double v = (deadFuelMoistCont - dfmc_[j])/(dfmc_[j + 1] - dfmc_[j]);
+
+  const Outputs& a = at(i, j);
+  const Outputs& b = at(i + 1, j);
+  const Outputs& c = at(i, j + 1);
+  const Outputs& d = at(i + 1, j + 1);
+  for (int k = 0; k < NUM_OUTPUTS; ++k)
+    outputs[k] = (1 - u)*((1 - v)*a[k] + v*c[k]) + u*((1 - v)*b[k] + v*d[k]);
+  return true;
+}
+
+#endif //EMULATOR_INLINE_H
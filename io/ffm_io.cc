@@ -1,10 +1,13 @@
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <map>
-#include <regex>
 #include <set>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -23,15 +26,35 @@
 #include "ffm_util.h"
 #include "ffm_io.h"
 #include "results.h"
+#include "site_inputs.h"
+#include "input_document.h"
 
-// Used by function stringToDouble to check the format
-// of string values representing doubles. Note that 
-// where a decimal point is present, it must be preceded by
-// one or more digits. So "0.1" is valid but ".1" is not.
-// Exponential format is supported (e.g. "100e-2").
-//
-const std::regex DOUBLE_FORMAT("((\\+|-)?[[:digit:]]+)(\\.(([[:digit:]]+)?))?((e|E)((\\+|-)?)[[:digit:]]+)?");
-
+/*!\brief Splits a line from the input text file into a key and a value
+  \param line
+  \param key Set to the text to the left of the first '=' character, converted 
+  to lower case and with all white space removed
+  \param value Set to a view into line of the text to the right of the '=' character, 
+  with leading and trailing white space removed
+  \return The number of tokens found, 0, 1 or 2
+
+  The rules are those of processLine but nothing is copied apart from the 
+  key, which is written into the caller's buffer so that a buffer reused across
+  lines does not allocate. value is only meaningful when 2 is returned and 
+  remains valid for as long as the storage behind line.
+*/
+int tokenizeLine(std::string_view line, std::string& key, std::string_view& value) {
+  key.clear();
+  value = std::string_view();
+  line = ffm_util::trimView(line);
+  line = line.substr(0, line.find('#')); //ignore everything after a # character
+  std::string_view first;
+  if (!ffm_util::nextField(line, '=', first)) 
+    return 0;
+  for (const char c : first)
+    if (!isspace(static_cast<unsigned char>(c))) 
+      key.push_back(tolower(static_cast<unsigned char>(c)));
+  return ffm_util::nextField(line, '=', value) ? 2 : 1;
+}
 
 /*!\brief Processes a line from the input text file
   \param line
@@ -54,89 +77,326 @@ const std::regex DOUBLE_FORMAT("((\\+|-)?[[:digit:]]+)(\\.(([[:digit:]]+)?))?((e
 */
 std::vector<std::string> processLine(const std::string& line) {
   std::vector<std::string> retVal;
-  std::string l;
-  l = ffm_util::trim(line);
-  l = l.substr(0, l.find('#')); //erase everything after a # character
-  if (l.empty()) 
-    return retVal;
-  std::vector<std::string> strVec = ffm_util::split(l,'=');
-  std::string firstString = ffm_util::reduce(strVec.front());
-  std::transform(firstString.begin(), firstString.end(), firstString.begin(), ::tolower);
-  retVal.push_back(firstString);
-  if (strVec.size() > 1)
-    retVal.push_back(strVec.at(1));
+  std::string key;
+  std::string_view value;
+  int numTokens = tokenizeLine(line, key, value);
+  if (numTokens > 0)
+    retVal.push_back(key);
+  if (numTokens > 1)
+    retVal.push_back(std::string(value));
   return retVal;
 }
 
+/*!\brief Validated conversion from string to double
+  \param str
+  \param value Set to the double represented by str if str is valid
+  \return True if str is a valid number, false otherwise
+
+  Numbers have an optional sign, one or more digits, an optional decimal
+  point followed by zero or more digits and an optional exponent. Note that 
+  where a decimal point is present, it must be preceded by one or more digits. 
+  So "0.1" is valid but ".1" is not. Exponential format is supported 
+  (e.g. "100e-2"). No white space is allowed.
+*/
+bool parseDouble(std::string_view str, double& value) {
+  const size_t n = str.size();
+  size_t i = 0, start;
+  auto isDigit = [&str](const size_t& j){return str[j] >= '0' && str[j] <= '9';};
+
+  if (i < n && (str[i] == '+' || str[i] == '-')) ++i;
+  start = i;
+  while (i < n && isDigit(i)) ++i;
+  if (i == start) return false;
+  if (i < n && str[i] == '.') {
+    ++i;
+    while (i < n && isDigit(i)) ++i;
+  }
+  if (i < n && (str[i] == 'e' || str[i] == 'E')) {
+    ++i;
+    if (i < n && (str[i] == '+' || str[i] == '-')) ++i;
+    start = i;
+    while (i < n && isDigit(i)) ++i;
+    if (i == start) return false;
+  }
+  if (i != n) return false;
+
+  //from_chars does not accept a leading '+'
+  const char* first = str.data() + (str[0] == '+' ? 1 : 0);
+  auto res = std::from_chars(first, str.data() + n, value);
+  if (res.ec == std::errc::result_out_of_range)
+    value = ffm_util::toDouble(str);
+  return true;
+}
+
 /*!\brief Conversion from string to double
   \param str Assumes str is a comma separated list of strings, might be only one in the list
   \return The double represented by the FIRST element of the list
+
+  If the first element is not a valid number (see parseDouble) then an 
+  InputError is thrown.
 */
-double stringToDouble(const std::string& str) {
-  std::vector<std::string> strVec = ffm_util::split(str, ',');
-  std::string first = strVec.at(0);
-
-  if (std::regex_match(first, DOUBLE_FORMAT))
-    return atof(strVec.at(0).c_str());
-  else {
-    std::cout << "Invalid numeric format (" << first << ")" << std::endl;
-    exit(1);
+double stringToDouble(std::string_view str) {
+  std::string_view first;
+  double value;
+  if (!ffm_util::nextField(str, ',', first) || !parseDouble(first, value)) {
+    throw InputError("Invalid numeric format (" + std::string(first) + ")");
   }
-    
+  return value;
 }
 
-/*!\brief Initial parse of input file
+/*!\brief Reads a whole input file
   \param inPath input file path
-  \return A pair consisting of the output level desired (Results::OutputLevelType)
-          and the number of monte carlo iterations (if applicable) 
+  \return The contents of the file, or an empty string if it cannot be read
 */
-std::pair<Results::OutputLevelType, int> prelimParseInputTextFile(std::string inPath) {
-  //provides an intial parse of the input file, to find output type and the number of monte carlo
-  //iterations if applicable
-
-  //file parsing variables
-  std::ifstream inFile(inPath);
-  std::string line;
-  std::string firstString, secondString;
-  std::vector<std::string> strVec;
-
-  //other variables
-  Results::OutputLevelType outputLevel = Results::COMPREHENSIVE;
-  int numIterations = -1;
-  
+std::string readInputFile(const std::string& inPath) {
+  std::ifstream inFile(inPath, std::ios::binary);
+  std::string contents;
+  if (!inFile) 
+    return contents;
+  inFile.seekg(0, std::ios::end);
+  std::streamoff size = inFile.tellg();
+  if (size <= 0) 
+    return contents;
+  contents.resize(size);
+  inFile.seekg(0, std::ios::beg);
+  inFile.read(&contents[0], size);
+  contents.resize(inFile.gcount());
+  return contents;
+}
+
+namespace {
+
   //map to parse Results::OutputLevelType
-  std::map<std::string, Results::OutputLevelType> outputLevelTypeMap = { {"basic", Results::BASIC},
-									 {"1", Results::BASIC},
-									 {"detailed", Results::DETAILED},
-									 {"2", Results::DETAILED},
-									 {"comprehensive", Results::COMPREHENSIVE},
-									 {"3", Results::COMPREHENSIVE},
-									 {"montecarlo", Results::MONTE_CARLO},
-									 {"4", Results::MONTE_CARLO} };
-
-  while(getline(inFile, line)) {
-
-    std::vector<std::string> strVec = processLine(line);
-    if (strVec.size() < 2) continue;
-    firstString = strVec.front();
-    secondString = strVec.back();
+  const std::map<std::string, Results::OutputLevelType> outputLevelTypeMap = 
+    { {"basic", Results::BASIC},
+      {"1", Results::BASIC},
+      {"detailed", Results::DETAILED},
+      {"2", Results::DETAILED},
+      {"comprehensive", Results::COMPREHENSIVE},
+      {"3", Results::COMPREHENSIVE},
+      {"montecarlo", Results::MONTE_CARLO},
+      {"4", Results::MONTE_CARLO} };
+
+  //map to parse Stratum::LevelType
+  const std::map<std::string, Stratum::LevelType> levelTypeMap = 
+    { {"nearsurface", Stratum::NEAR_SURFACE},
+      {"ns", Stratum::NEAR_SURFACE},
+      {"elevated", Stratum::ELEVATED},
+      {"e", Stratum::ELEVATED},
+      {"midstorey", Stratum::MID_STOREY},
+      {"m", Stratum::MID_STOREY},
+      {"canopy", Stratum::CANOPY},
+      {"c", Stratum::CANOPY} };
+
+  //map to parse Forest::StrataOverlapType
+  const std::map<std::string, Forest::StrataOverlapType> overlapTypeMap = 
+    { {"automatic", Forest::AUTO_CALC_OVERLAP},
+      {"auto", Forest::AUTO_CALC_OVERLAP},
+      {"notoverlapped", Forest::NOT_OVERLAPPED},
+      {"no", Forest::NOT_OVERLAPPED},
+      {"false", Forest::NOT_OVERLAPPED},
+      {"overlapped", Forest::OVERLAPPED},
+      {"yes", Forest::OVERLAPPED},
+      {"true", Forest::OVERLAPPED} };
+
+  //map to parse Species::LeafFormType
+  const std::map<std::string, Species::LeafFormType> leafFormTypeMap = 
+    { {"round", Species::ROUND_LEAF},
+      {"flat", Species::FLAT_LEAF} };
+
+  //keys that are only recognised between "begin species" and "end species"
+  const std::set<std::string> speciesKeys = 
+    { "composition", "name", "hc", "he", "ht", "hp", "w", "liveleafmoisture", 
+      "silicafreeashcontent", "ignitiontemperature", "leafform", "leafthickness", 
+      "leafwidth", "leaflength", "leafseparation", "stemorder", "clumpseparation", 
+      "clumpdiameter", "proportiondead" };
+
+  //keys of the surface, weather and other site inputs
+  const std::set<std::string> siteKeys = 
+    { "slope", "fuelloadtonnesperhectare", "meanfueldiameter", "meanfinenessleaves",
+      "airtemperature", "firelinelength", "incidentwindspeed" };
+
+  Stratum::LevelType parseLevel(std::string_view str) {
+    std::string tmp = ffm_util::reduce(std::string(str));
+    std::transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
+    return levelTypeMap.at(tmp);
+  }
+
+}
+
+/*!\brief Read an input file in a single pass
+  \param inPath input file path
+  \return The assignments of the file, see parseInputText
+*/
+InputDocument parseInputDocument(const std::string& inPath) {
+  std::string contents = readInputFile(inPath);
+  return parseInputText(contents);
+}
+
+/*!\brief Read the contents of an input file in a single pass
+  \param contents The text of an input file
+  \return The assignments of the text, grouped into output settings, site entries and strata
+
+  Misplaced begin and end lines, and a stratum still open at the end of the text, are 
+  reported here by throwing an InputError. Values are 
+  not converted, apart from the output level, the number of Monte Carlo iterations, 
+  stratum levels, stratum gaps and overlaps, so numeric problems are reported when the 
+  document is resolved (see resolveSiteInputs). As before only the first "surface dead 
+  fuel moisture content" and "stratum gaps" lines are used, wherever they appear.
+*/
+InputDocument parseInputText(std::string_view contents) {
+
+  // file parsing variables
+  std::string_view rest(contents), line;
+  std::string firstString;
+  std::string_view secondString;
+  int numTokens;
+  bool speciesInFlag = false, stratumInFlag = false, gapsRead = false;
+
+  InputDocument doc;
+
+  while (ffm_util::nextField(rest, '\n', line)) {
+
+    numTokens = tokenizeLine(line, firstString, secondString);
+    if (numTokens == 0) continue;
+
+    //first we treat all the valid input lines that are not assigning a value
+    //in other words there will be a single token
+
+    if (firstString == "beginstratum") {
+      if (stratumInFlag) {
+	throw InputError("Problem with input file - misplaced begin stratum");
+      }
+      stratumInFlag = true;
+      doc.strata.emplace_back();
+      continue;
+    }
+
+    //a species left open would otherwise lose its stratum
+    if (firstString == "endstratum") {
+      if (!stratumInFlag || speciesInFlag) {
+	throw InputError("Problem with input file - misplaced end stratum");
+      }
+      stratumInFlag = false;
+      continue;
+    }
+
+    if (firstString == "beginspecies") {
+      if (speciesInFlag) { 
+	throw InputError("Problem with input file - misplaced begin species");
+      }
+      //a species outside a stratum can never have valid values
+      if (!stratumInFlag) {
+	throw InputError("Problem with input values for species ");
+      }
+      speciesInFlag = true;
+      doc.strata.back().species.emplace_back();
+      continue;
+    }
+
+    if (firstString == "endspecies") {
+      if (!speciesInFlag) {
+	throw InputError("Problem with input file - misplaced end species");
+      }
+      speciesInFlag = false;
+      continue;
+    }
+
+    //now we treat the input lines that are making an assignment, so that there 
+    //should be something to the right of the '=' sign, ie there should be 2 tokens
+
+    if (numTokens < 2) continue;
+
+    if (speciesInFlag && speciesKeys.count(firstString)) {
+      doc.strata.back().species.back().entries.push_back({firstString, std::string(secondString)});
+      continue;
+    }
+
+    if (stratumInFlag) {
+      if (firstString == "level") {
+	doc.strata.back().level = parseLevel(secondString);
+	continue;
+      }
+ 
+      if (firstString == "plantseparation") {
+	doc.strata.back().entries.push_back({firstString, std::string(secondString)});
+	continue;
+      }
+    }
 
     // output level
     if (firstString == "outputlevel"){
-      secondString = ffm_util::reduce(secondString);
-      std::transform(secondString.begin(), secondString.end(), secondString.begin(), ::tolower);
-      outputLevel = outputLevelTypeMap.at(secondString);
+      std::string tmp = ffm_util::reduce(std::string(secondString));
+      std::transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
+      doc.outputLevel = outputLevelTypeMap.at(tmp);
       continue;
     }
 
     //number of Monte Carlo iterations
     if (firstString == "montecarloiterations") {
-      numIterations = atoi(secondString.c_str()); 
+      doc.monteCarloIterations = atoi(std::string(secondString).c_str()); 
+      continue;
+    }
+
+    if (firstString == "stratumgaps") {
+      if (!gapsRead) {
+	std::string_view levels = secondString, levelStr;
+	while (ffm_util::nextField(levels, ',', levelStr))
+	  doc.strataWithGaps.insert(parseLevel(levelStr));
+	gapsRead = true;  // ignore any subsequent "stratum gaps" lines
+      }
+      continue;
+    }
+
+    //At the moment there is no input for species dead fuel moisture content, although Species
+    //objects have deadLeafMoisture_ data member. So the surface dead fuel moisture content is used
+    //to fill the deadLeafMoisture_ data member for each instantiated Species object, and it is 
+    //held apart from the other entries so that it need not occur first in the input text file
+    if (firstString == "surfacedeadfuelmoisturecontent") {
+      if (!doc.hasDeadFuelMoistCont) {
+	doc.deadFuelMoistCont = std::string(secondString);
+	doc.hasDeadFuelMoistCont = true;
+      }
       continue;
     }
+
+    if (firstString == "overlapping"){
+      std::vector<std::string> tmp = ffm_util::split(std::string(secondString), ',');
+      if (tmp.size() == 3) {
+	doc.strataOverlaps.push_back(std::make_tuple(levelTypeMap.at(ffm_util::reduce(tmp[0])), 
+						     levelTypeMap.at(ffm_util::reduce(tmp[1])), 
+						     overlapTypeMap.at(ffm_util::reduce(tmp[2]))
+						     )
+				     );
+      }
+      continue;
+    }
+
+    if (siteKeys.count(firstString))
+      doc.siteEntries.push_back({firstString, std::string(secondString)});
+
+  }  //end of file contents
+
+  //a stratum, or a species in it, left open at the end of the file was once dropped 
+  //without notice, which changes the results, so it is reported instead
+  if (stratumInFlag) {
+    throw InputError("Problem with input file - missing end stratum");
   }
 
-  return std::make_pair(outputLevel, numIterations);
+  return doc;
+}
+
+/*!\brief Initial parse of input file
+  \param inPath input file path
+  \return A pair consisting of the output level desired (Results::OutputLevelType)
+          and the number of monte carlo iterations (if applicable) 
+
+  This reads the whole file, callers that go on to read the site inputs should 
+  use parseInputDocument and resolveSiteInputs instead.
+*/
+std::pair<Results::OutputLevelType, int> prelimParseInputTextFile(std::string inPath) {
+  InputDocument doc = parseInputDocument(inPath);
+  return std::make_pair(doc.outputLevel, doc.monteCarloIterations);
 }
 
 
@@ -146,200 +406,119 @@ std::pair<Results::OutputLevelType, int> prelimParseInputTextFile(std::string in
 \return A location object that is constructed from the contents of inputFileName
 */
 Location parseInputTextFile(const std::string& inPath, const bool& monteCarlo) {
+  SiteInputs inputs;
+  if (!parseSiteInputs(inPath, monteCarlo, inputs))
+    return Location();
+  return buildLocation(inputs);
+}
 
-  // file parsing variables
-  std::ifstream inFile(inPath);
-  std::string line;
-  std::string firstString;
-  std::string secondString;
-  std::vector<std::string> strVec;
-  bool speciesInFlag = false, stratumInFlag = false;
+/*!\brief Parse input file into site inputs
+\param inPath input file path
+\param monteCarlo
+\param inputs Filled with the inputs read from inPath
+\return False if this is a Monte Carlo run and the sampled inputs are unusable, true otherwise
+
+Problems with the inputs of a run that is not Monte Carlo are reported by throwing an InputError.
+*/
+bool parseSiteInputs(const std::string& inPath, const bool& monteCarlo, SiteInputs& inputs) {
+  return resolveSiteInputs(parseInputDocument(inPath), monteCarlo, inputs);
+}
+
+/*!\brief Resolve an input document into site inputs
+\param doc
+\param monteCarlo If true then values are sampled, so that every call gives a new site
+\param inputs Filled with the inputs of doc
+\return False if this is a Monte Carlo run and the sampled inputs are unusable, true otherwise
+
+Problems with the inputs of a run that is not Monte Carlo are reported by throwing an InputError.
+*/
+bool resolveSiteInputs(const InputDocument& doc, const bool& monteCarlo, SiteInputs& inputs) {
 
   // stratum variables
   std::vector<Species> specVec;
-  std::vector<Stratum> stratVec;
+  std::vector<SiteInputs::SpeciesInputs> specInputsVec;
+  std::vector<SiteInputs::StratumInputs> stratInputsVec;
   double psep;
-  Stratum::LevelType level;
 
-  // species variables
+  // species variables, note that w, lform and hpMean carry over from one species to the next
   std::string spname;
-  Poly crn;
-  double hc, he, ht, hp, hpMean, w;
+  double hc, he, ht, hp, hpMean = -99, w = -99;
   double lmoist,sfac,itemp,lthick,lwidth,llength,lsep,sord,csep,cdiam,pdead;
-  Species::LeafFormType lform;
+  Species::LeafFormType lform = Species::ROUND_LEAF;
   double comp;
 
   // surface variables
-  double slope, dfmc, fuelload, fueldiam, thickl;
+  double slope = -99, dfmc = -99, fuelload = -99, fueldiam = -99, thickl = -99;
 
   //weather variables
-  double airtemp;
+  double airtemp = -99;
 
   // other variables
-  double firelineLength;
-  double incidentWindSpeed;
-  std::vector<Forest::StrataOverlap> strataOverlapVec;
-
-  //map to parse Stratum::LevelType
-  std::map<std::string, Stratum::LevelType> levelTypeMap;
-  levelTypeMap = { {"nearsurface", Stratum::NEAR_SURFACE},
-		   {"ns", Stratum::NEAR_SURFACE},
-		   {"elevated", Stratum::ELEVATED},
-		   {"e", Stratum::ELEVATED},
-		   {"midstorey", Stratum::MID_STOREY},
-		   {"m", Stratum::MID_STOREY},
-		   {"canopy", Stratum::CANOPY},
-		   {"c", Stratum::CANOPY} };
-
-  //map to parse Forest::StrataOverlapType
-  std::map<std::string, Forest::StrataOverlapType> overlapTypeMap;
-  overlapTypeMap = { {"automatic", Forest::AUTO_CALC_OVERLAP},
-		     {"auto", Forest::AUTO_CALC_OVERLAP},
-		     {"notoverlapped", Forest::NOT_OVERLAPPED},
-		     {"no", Forest::NOT_OVERLAPPED},
-		     {"false", Forest::NOT_OVERLAPPED},
-		     {"overlapped", Forest::OVERLAPPED},
-		     {"yes", Forest::OVERLAPPED},
-		     {"true", Forest::OVERLAPPED} };
-
-  //map to parse Species::LeafFormType
-  std::map<std::string, Species::LeafFormType> leafFormTypeMap;
-  leafFormTypeMap = { {"round", Species::ROUND_LEAF},
-		      {"flat", Species::FLAT_LEAF} };
-
-
-  // read the file contents into a vector of strings
-  std::vector<std::string> LINES;
-  {
-    std::string s;
-    while (getline(inFile, s)) {
-      LINES.push_back(s);
+  double firelineLength = -99;
+  double incidentWindSpeed = -99;
+
+  if (doc.hasDeadFuelMoistCont) {
+    dfmc = monteCarlo ? ffm_util::randomNormal(doc.deadFuelMoistCont) : stringToDouble(doc.deadFuelMoistCont); 
+    if (dfmc <= 0){
+      if (monteCarlo) 
+	return false;
+      else {
+	throw InputError("Problem with input file - surface dead fuel moisture content");
+      }
     }
   }
 
+  for (const InputDocument::Entry& entry : doc.siteEntries) {
+    const std::string& firstString = entry.key;
+    const std::string& secondString = entry.value;
 
-  //At the moment there is no input for species  dead fuel moisture content, although Species
-  //objects have deadLeafMoisture_ data member. So the surface dead fuel moisture content is used
-  //to fill the deadLeafMoisture_ data member for each instantiated Species object. So we need a
-  //preliminary file read to get surface dead fuel moisture content which will be used in each species
-  //this obviates the need for the surface variables to occur first in the input text file
-  //this hack can be eliminated if/when dfmc is specified on a species by species basis
-  dfmc = -99;
-  for (auto &line : LINES) {
-    std::vector<std::string> strVec = processLine(line);
-    if (strVec.size() < 2) continue;
-    firstString = strVec.front();
-    secondString = strVec.back();
-    if (firstString == "surfacedeadfuelmoisturecontent") {
-      dfmc = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString); 
-      if (dfmc <= 0){
+    // Surface variables
+    if (firstString == "slope") {slope = ffm_util::toDouble(secondString)*PI/180.0; continue;}
+
+    if (firstString == "fuelloadtonnesperhectare") {
+      //note conversion to kg/m^2
+      fuelload = monteCarlo ? ffm_util::randomNormal(secondString)*0.1 : stringToDouble(secondString)*0.1;
+      if (fuelload < 0.4) { 
 	if (monteCarlo) 
-	  return Location();
-	else {
-	  std::cout << "Problem with input file - surface dead fuel moisture content" << std::endl;
-	  exit(1);
+	  return false;
+	else { 
+	  throw InputError("Problem with input file - check fuel load tonnes per hectare");
 	}
       }
-      break;
-    }
-  }
-  
-  // Look for stratum gap parameters if present
-  //
-  std::set<Stratum::LevelType> strataWithGaps;
-  for (auto &line : LINES) {
-    std::vector<std::string> strVec = processLine(line);
-    if (strVec.size() < 2) continue;
-    firstString = strVec.front();
-    secondString = strVec.back();
-
-    if (firstString == "stratumgaps") {
-      std::vector<std::string> levels = ffm_util::split(secondString, ',');
-      for (auto &levelStr : levels) {
-        std::string s = ffm_util::reduce(levelStr);
-        std::transform(s.begin(), s.end(), s.begin(), ::tolower);
-        strataWithGaps.insert( levelTypeMap.at(s) );
-      }
+      continue;
+    } 
 
-      break;  // ignore any subsequent "stratum gaps" lines
-    }
-  }
+    if (firstString == "meanfueldiameter") {fueldiam = ffm_util::toDouble(secondString); continue;}
 
-  // Now process parameters as a whole
-  //
-  for (auto &line : LINES) {
+    if (firstString == "meanfinenessleaves") {thickl = ffm_util::toDouble(secondString); continue;}
 
-    std::vector<std::string> strVec = processLine(line);
-    if (strVec.empty()) continue;
-    firstString = strVec.front();
-    secondString = strVec.back();
+    //Weather variables
+    if (firstString == "airtemperature") {
+      airtemp = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
+      continue;
+    }
 
-    //first we treat all the valid input lines that are not assigning a value
-    //in other words strVec will have size 1
+    //the other stuff
+    if (firstString == "firelinelength") {firelineLength = ffm_util::toDouble(secondString); continue;}
 
-    if (firstString == "beginstratum") {
-      if (stratumInFlag) {
-	std::cout << "Problem with input file - misplaced begin stratum" << std::endl;
-	exit(1);
-      }
-      stratumInFlag = true;
-      specVec.clear();
-      level = Stratum::UNKNOWN_LEVEL;
-      psep = -99;
+    //incident windspeed is converted from km/h to m/s
+    if (firstString == "incidentwindspeed") {
+      incidentWindSpeed = monteCarlo ? ffm_util::randomNormal(secondString)/3.6 : stringToDouble(secondString)/3.6;
       continue;
     }
+  }
 
-    if (firstString == "endstratum") {
-      if (!stratumInFlag) {
-	std::cout << "Problem with input file - misplaced end stratum" << std::endl;
-	exit(1);
-      }
-      stratumInFlag = false;
+  for (const InputDocument::StratumBlock& stratum : doc.strata) {
+    const Stratum::LevelType& level = stratum.level;
+    specVec.clear();
+    specInputsVec.clear();
+    psep = -99;
 
-      //if level was not set or level is already in stratVec then skip this stratum
-      if (level == Stratum::UNKNOWN_LEVEL) continue;
-      if (find_if(stratVec.begin(), 
-		  stratVec.end(), 
-		  [level](Stratum s){return level == s.level();}) 
-	  < stratVec.end()) continue;
-     
-      const Stratum& s = Stratum(level, specVec, psep, true);
-
-      // If this is a monte-carlo run, and we are modelling gaps for this stratum,
-      // then we take stratum cover as the probability of including the stratum in
-      // the stand. If not a monte-carlo run, the stratum is included regardless 
-      // of cover.
-      bool addStratum = false;
-      if (monteCarlo) {
-        if (strataWithGaps.find(s.level()) != strataWithGaps.end()) { 
-          // Modelling gaps for this stratum - use cover as probability of inclusion
-          addStratum = ffm_util::randomUniform() < s.cover();
-        }
-        else {
-          // Not modelling gaps so include stratum
-          addStratum = true;
-        }
-
-      } else {
-        // Not  a monte-carlo run so include stratum
-        addStratum = true;
-      }
+    for (const InputDocument::Entry& entry : stratum.entries)
+      if (entry.key == "plantseparation")
+	psep = monteCarlo ? ffm_util::randomNormal(entry.value) : stringToDouble(entry.value);
 
-      if (addStratum) {
-        stratVec.push_back(s);
-      } else {
-        // recreate the Stratum with the include flag set to false
-        stratVec.push_back( Stratum(level, specVec, psep, false) );
-      }
-      continue;
-    }
-      
-    if (firstString == "beginspecies") {
-      if (speciesInFlag) { 
-	std::cout << "Problem with input file - misplaced begin species" << std::endl;
-	exit(1);
-      }
-      speciesInFlag = true;
+    for (const InputDocument::SpeciesBlock& sp : stratum.species) {
       //clear species variables ready for read
       comp = 0;
       hc = -99;
@@ -347,7 +526,6 @@ Location parseInputTextFile(const std::string& inPath, const bool& monteCarlo) {
       ht = -99;
       hp = -99;
       spname = "";
-      crn = Poly();
       lmoist = -99;
       sfac = -99;
       itemp = -99;
@@ -359,15 +537,110 @@ Location parseInputTextFile(const std::string& inPath, const bool& monteCarlo) {
       cdiam = -99;
       csep = -99;
       pdead = -99;
-      continue;
-    }
 
-    if (firstString == "endspecies") {
-      if (!speciesInFlag) {
-	std::cout << "Problem with input file - misplaced end species" << std::endl; 
-	exit(1);
+      for (const InputDocument::Entry& entry : sp.entries) {
+	const std::string& firstString = entry.key;
+	const std::string& secondString = entry.value;
+
+	if (firstString == "composition") {
+	  comp = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "name") {spname = secondString; continue;}
+
+	// crown geometry - note that if monteCarlo then hc, he, ht and w will be 
+	// scaled by hp / mean_of_hp, but this has to happen when the entire species 
+	// has been read
+
+	if (firstString == "hc" ) {
+	  hc = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+ 
+	if (firstString == "he" ) {
+	  he = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "ht" ) {
+	  ht = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "hp" ) { 
+	  hp = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  hpMean = stringToDouble(secondString);
+	  continue;
+	}
+ 
+	if (firstString == "w" ) {
+	  w = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+ 
+	if (firstString == "liveleafmoisture") {
+	  lmoist = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "silicafreeashcontent") {
+	  sfac = stringToDouble(secondString); 
+	  continue;
+	}
+
+	if (firstString == "ignitiontemperature") {
+	  itemp = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "leafform"){
+	  std::string tmp(secondString);
+	  std::transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
+	  lform = leafFormTypeMap.at(tmp);
+	  continue;
+	}
+
+	if (firstString == "leafthickness") {
+	  lthick = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "leafwidth") {
+	  lwidth = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "leaflength") {
+	  llength = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "leafseparation") {
+	  lsep = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "stemorder") {
+	  sord = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "clumpseparation") {
+	  csep = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "clumpdiameter") {
+	  cdiam = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
+	  continue;
+	}
+
+	if (firstString == "proportiondead") {
+	  pdead = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
+	  continue;
+	}
       }
-      speciesInFlag = false;
 
       //if monte carlo then scale the plant geometry. 
       if (monteCarlo) {
@@ -377,243 +650,368 @@ Location parseInputTextFile(const std::string& inPath, const bool& monteCarlo) {
 	w  *= hp/hpMean;
       }
 
+      SiteInputs::SpeciesInputs specInputs;
+      specInputs.name = spname;
+      specInputs.composition = comp;
+      specInputs.hc = hc;
+      specInputs.he = he;
+      specInputs.ht = ht;
+      specInputs.hp = hp;
+      specInputs.w = w;
+      specInputs.liveLeafMoisture = lmoist;
+      specInputs.propDead = pdead;
+      specInputs.silFreeAshCont = sfac;
+      specInputs.ignitTemp = itemp;
+      specInputs.leafForm = lform;
+      specInputs.leafThick = lthick;
+      specInputs.leafWidth = lwidth;
+      specInputs.leafLength = llength;
+      specInputs.leafSep = lsep;
+      specInputs.stemOrder = sord;
+      specInputs.clumpDiam = cdiam;
+      specInputs.clumpSep = csep;
+
       //check the species values
-      bool speciesOkay = true;
-      if (ht < he                   || 
-	  hp <= hc                  ||
-	  comp < 0                  ||
-	  lmoist < 0                ||
-	  lthick < 0                ||
-	  lwidth < 0                ||
-	  llength < 0               ||
-	  lsep <= 0                 ||
-	  pdead < 0                 ||
-	  pdead > 1                 ||
-	  sord <= 0                 ||
-	  csep < 0                  ||
-	  cdiam <= 0                ||
-	  (itemp <= 0 && sfac <= 0)
-	  ) speciesOkay = false;
-
-      if (!speciesOkay) {
+      if (!checkSpeciesInputs(specInputs)) {
 	if (monteCarlo) 
-	  return Location();
+	  return false;
 	else {
-	  std::cout << "Problem with input values for species " + spname;
-	  exit(1);
+	  throw InputError("Problem with input values for species " + spname);
 	}
       }
 
-
       // So far so good. Now create a Species object and check that its 
       // internal checks have not picked up any problems.
-      const Species& species = Species(comp, spname, hc, he, ht, hp, w, lmoist, dfmc, pdead, sfac,  
-		      itemp, lform,lthick,lwidth, llength, lsep, sord, cdiam, csep);
+      const Species& species = buildSpecies(specInputs, dfmc);
 
       if (!species.isValid()) {
 	if (monteCarlo) 
-	  return Location();
+	  return false;
 	else {
-	  std::cout << "Problem with input values for species " + spname;
-	  exit(1);
+	  throw InputError("Problem with input values for species " + spname);
 	}
       }
 
       specVec.push_back(species);
-      continue;
+      specInputsVec.push_back(specInputs);
     }
 
-    //now we treat the input lines that are making an assignment, so that there 
-    //should be something to the right of the '=' sign, ie strVec.size() should be 2
-
-    if (strVec.size() < 2) continue;
-
-    if (speciesInFlag && stratumInFlag) {
-
-      if (firstString == "composition") {
-	comp = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
-	continue;
+    //if level was not set or level has already been read then skip this stratum
+    if (level == Stratum::UNKNOWN_LEVEL) continue;
+    if (find_if(stratInputsVec.begin(), 
+		stratInputsVec.end(), 
+		[level](const SiteInputs::StratumInputs& s){return level == s.level;}) 
+	< stratInputsVec.end()) continue;
+
+    // If this is a monte-carlo run, and we are modelling gaps for this stratum,
+    // then we take stratum cover as the probability of including the stratum in
+    // the stand. If not a monte-carlo run, the stratum is included regardless 
+    // of cover.
+    bool addStratum = false;
+    if (monteCarlo) {
+      if (doc.strataWithGaps.find(level) != doc.strataWithGaps.end()) { 
+	// Modelling gaps for this stratum - use cover as probability of inclusion
+	addStratum = ffm_util::randomUniform() < Stratum(level, specVec, psep, true).cover();
       }
-
-      if (firstString == "name") {spname = secondString; continue;}
-
-      // crown geometry - note that if monteCarlo then hc, he, ht and w will be 
-      // scaled by hp / mean_of_hp, but this has to happen when the entire species 
-      // has been read, ie when firstString == endspecies
-
-      if (firstString == "hc" ) {
-	hc = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
- 
-      if (firstString == "he" ) {
-	he = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
- 	continue;
+      else {
+	// Not modelling gaps so include stratum
+	addStratum = true;
       }
 
-      if (firstString == "ht" ) {
-	ht = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
- 	continue;
-      }
+    } else {
+      // Not  a monte-carlo run so include stratum
+      addStratum = true;
+    }
 
-      if (firstString == "hp" ) { 
-	hp = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	hpMean = stringToDouble(secondString);
-	continue;
-      }
- 
-      if (firstString == "w" ) {
-	w = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
- 
-      if (firstString == "liveleafmoisture") {
-	lmoist = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
-	continue;
-      }
+    SiteInputs::StratumInputs stratInputs;
+    stratInputs.level = level;
+    stratInputs.plantSep = psep;
+    stratInputs.include = addStratum;
+    stratInputs.species = specInputsVec;
+    stratInputsVec.push_back(stratInputs);
+  }
 
-      if (firstString == "silicafreeashcontent") {
-	sfac = stringToDouble(secondString); 
-	continue;
-      }
+  inputs.outputLevel = doc.outputLevel;
+  inputs.slope = slope;
+  inputs.deadFuelMoistCont = dfmc;
+  inputs.fuelLoad = fuelload;
+  inputs.meanFuelDiameter = fueldiam;
+  inputs.meanFinenessLeaves = thickl;
+  inputs.airTemp = airtemp;
+  inputs.incidentWindSpeed = incidentWindSpeed;
+  inputs.firelineLength = firelineLength;
+  inputs.strata = stratInputsVec;
+  inputs.strataOverlaps = doc.strataOverlaps;
+  return true;
+}
 
-      if (firstString == "ignitiontemperature") {
-	itemp = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
+/*!\brief Check the values of a species
+\param sp
+\return False if any value is out of range
 
-      if (firstString == "leafform"){
-	std::string tmp = secondString;
-	std::transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
-	lform = leafFormTypeMap.at(tmp);
-	continue;
-      }
+This is the check made on every species read from an input file. A species that 
+passes may still be rejected by its own checks, see Species::isValid.
+*/
+bool checkSpeciesInputs(const SiteInputs::SpeciesInputs& sp) {
+  return !(sp.ht < sp.he                   || 
+	   sp.hp <= sp.hc                  ||
+	   sp.composition < 0              ||
+	   sp.liveLeafMoisture < 0         ||
+	   sp.leafThick < 0                ||
+	   sp.leafWidth < 0                ||
+	   sp.leafLength < 0               ||
+	   sp.leafSep <= 0                 ||
+	   sp.propDead < 0                 ||
+	   sp.propDead > 1                 ||
+	   sp.stemOrder <= 0               ||
+	   sp.clumpSep < 0                 ||
+	   sp.clumpDiam <= 0               ||
+	   (sp.ignitTemp <= 0 && sp.silFreeAshCont <= 0));
+}
 
-      if (firstString == "leafthickness") {
-	lthick = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
+/*!\brief Check that a location can be constructed from site inputs
+\param inputs
+\return False if the inputs would be rejected when read from an input file, or 
+would end the program when the strata are constructed
 
-      if (firstString == "leafwidth") {
-	lwidth = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
+Inputs from resolveSiteInputs have already been checked apart from strata without 
+species and species with zero composition, which Stratum does not accept.
+*/
+bool checkSiteInputs(const SiteInputs& inputs) {
+  if (inputs.deadFuelMoistCont <= 0 || inputs.fuelLoad < 0.4) return false;
+  for (const SiteInputs::StratumInputs& st : inputs.strata) {
+    if (st.species.empty()) return false;
+    for (const SiteInputs::SpeciesInputs& sp : st.species)
+      if (sp.composition <= 0 || !checkSpeciesInputs(sp) ||
+	  !buildSpecies(sp, inputs.deadFuelMoistCont).isValid())
+	return false;
+  }
+  return true;
+}
 
-      if (firstString == "leaflength") {
-	llength = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
+/*!\brief Construct a species from species inputs
+\param sp
+\param dfmc The surface dead fuel moisture content, which is used for the dead leaves
+\return A Species object constructed from sp
+*/
+Species buildSpecies(const SiteInputs::SpeciesInputs& sp, const double& dfmc) {
+  return Species(sp.composition, sp.name, sp.hc, sp.he, sp.ht, sp.hp, sp.w, 
+		 sp.liveLeafMoisture, dfmc, sp.propDead, sp.silFreeAshCont,
+		 sp.ignitTemp, sp.leafForm, sp.leafThick, sp.leafWidth, sp.leafLength, 
+		 sp.leafSep, sp.stemOrder, sp.clumpDiam, sp.clumpSep);
+}
 
-      if (firstString == "leafseparation") {
-	lsep = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
+/*!\brief Construct a location from site inputs
+\param inputs
+\return A location object constructed from inputs
 
-      if (firstString == "stemorder") {
-	sord = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
+The inputs are assumed to have been checked, as they are by resolveSiteInputs.
+*/
+Location buildLocation(const SiteInputs& inputs) {
+  const double& dfmc = inputs.deadFuelMoistCont;
+  std::vector<Stratum> stratVec;
+  std::vector<Species> specVec;
+  stratVec.reserve(inputs.strata.size());
+  for (const auto& st : inputs.strata) {
+    specVec.clear();
+    for (const auto& sp : st.species)
+      specVec.push_back(buildSpecies(sp, dfmc));
+    stratVec.push_back(Stratum(st.level, specVec, st.plantSep, st.include));
+  }
 
-      if (firstString == "clumpseparation") {
-	csep = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
-	continue;
-      }
+  return Location(Forest(Surface(inputs.slope, dfmc, inputs.fuelLoad, 
+				 inputs.meanFuelDiameter, inputs.meanFinenessLeaves), 
+			 stratVec, inputs.strataOverlaps),
+		  Weather(inputs.airTemp),
+		  inputs.incidentWindSpeed,
+		  inputs.firelineLength);
+}
 
-      if (firstString == "clumpdiameter") {
-	cdiam = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
-	continue;
-      }
+/*!\brief Compute the results of a scenario document, as sent to the worker and server modes
+\param text The text of an input file
+\param res Set to the results when they can be computed
+\param error Set to a description of the problem otherwise
+\return True if res was set
 
-      if (firstString == "proportiondead") {
-	pdead = monteCarlo ? ffm_util::randomUniform(secondString) : stringToDouble(secondString);
-	continue;
-      }
+Monte Carlo inputs are not accepted. No problem with the inputs ends the program.
+*/
+bool scenarioResults(std::string_view text, Results& res, std::string& error) {
+  try {
+    InputDocument doc = parseInputText(text);
+    if (doc.outputLevel == Results::MONTE_CARLO) {
+      error = "Monte Carlo inputs cannot be served";
+      return false;
     }
-
-    if (stratumInFlag) {
-      if (firstString == "level") {
-	std::string tmp = secondString;
-	tmp = ffm_util::reduce(tmp);
-	std::transform(tmp.begin(), tmp.end(), tmp.begin(), ::tolower);
-	level = levelTypeMap.at(tmp);
-	continue;
-      }
- 
-      if (firstString == "plantseparation") {
-	psep = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
-	continue;
-      }
+    SiteInputs inputs;
+    resolveSiteInputs(doc, false, inputs);
+    if (!checkSiteInputs(inputs)) {
+      error = "Problem with input values";
+      return false;
     }
+    res = buildLocation(inputs).results(Results::DETAILED);
+    return true;
+  }
+  catch (const InputError& e) {
+    error = e.what();
+  }
+  catch (const std::out_of_range&) {
+    // an unknown name, such as a level or leaf form
+    error = "Problem with input file - unrecognised value";
+  }
+  return false;
+}
 
+/*!\brief The override named by an input file parameter
+  \param name One of incident wind speed, air temperature, surface dead fuel moisture 
+  content, slope, fireline length and fuel load tonnes per hectare (or fuel load), which 
+  as in the input file are case and white space insensitive
+  \return A pointer to the corresponding member of SiteOverrides, or null if name is 
+  not recognised
+*/
+double SiteOverrides::* overrideField(std::string_view name) {
+  const std::map<std::string, double SiteOverrides::*> fieldMap = 
+    { {"incidentwindspeed", &SiteOverrides::incidentWindSpeed},
+      {"airtemperature", &SiteOverrides::airTemp},
+      {"surfacedeadfuelmoisturecontent", &SiteOverrides::deadFuelMoistCont},
+      {"slope", &SiteOverrides::slope},
+      {"firelinelength", &SiteOverrides::firelineLength},
+      {"fuelloadtonnesperhectare", &SiteOverrides::fuelLoad},
+      {"fuelload", &SiteOverrides::fuelLoad} };
+
+  std::string key = ffm_util::reduce(std::string(name));
+  std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+  auto it = fieldMap.find(key);
+  return it == fieldMap.end() ? nullptr : it->second;
+}
 
-    // Surface variables
-    if (firstString == "slope") {slope = atof(secondString.c_str())*PI/180.0; continue;}
-
-    //// the following is commented out because the surface dead fuel moisture content is currently
-    //// read in a preliminary pass through the file for reasons noted above. This might be uncommented
-    //// in future versions of the model
-
-    // if (firstString == "surfacedeadfuelmoisturecontent") {
-    //   dfmc = monteCarlo ? randomNormal(secondString) : stringToDouble(secondString);
-    //   continue;
-    // }
-
-    if (firstString == "fuelloadtonnesperhectare") {
-      //note conversion to kg/m^2
-      fuelload = monteCarlo ? ffm_util::randomNormal(secondString)*0.1 : stringToDouble(secondString)*0.1;
-      if (fuelload < 0.4) { 
-	if (monteCarlo) 
-	  return Location();
-	else { 
-	  std::cout << "Problem with input file - check fuel load tonnes per hectare" << std::endl;
-	  exit(1);
+/*!\brief Parse a table of overrides
+  \param inPath path of a CSV file
+  \param labels If not null, the table must have a column named labelColumn, whose
+  cells are returned here, one for each row, rather than read as numbers
+  \param labelColumn In lower case, the name is matched regardless of case
+  \return One SiteOverrides object for each row of the table after the first
+
+  The first row names the columns, using the names of the input file parameters 
+  (incident wind speed, air temperature, surface dead fuel moisture content, slope, 
+  fireline length and fuel load tonnes per hectare), which as in the input file are 
+  case and white space insensitive. Each subsequent row gives the values to be used 
+  for one run, in the units of the input file. An empty cell leaves the value from 
+  the input file unchanged. Blank lines and anything following a '#' are ignored.
+*/
+std::vector<SiteOverrides> parseOverrideTable(const std::string& inPath, 
+					      std::vector<std::string>* labels,
+					      const std::string& labelColumn) {
+  std::string contents = readInputFile(inPath);
+  std::string_view rest(contents), line;
+  std::vector<double SiteOverrides::*> columns;
+  std::vector<SiteOverrides> rows;
+  bool headerRead = false;
+  size_t labelCol = std::string::npos;
+
+  while (ffm_util::nextField(rest, '\n', line)) {
+    line = ffm_util::trimView(line.substr(0, line.find('#')), " \t\r");
+    if (line.empty()) continue;
+
+    //unlike split, empty cells are kept so that columns stay aligned
+    SiteOverrides row;
+    size_t col = 0;
+    for (size_t pos = 0; pos <= line.size(); ++col) {
+      size_t end = std::min(line.find(',', pos), line.size());
+      std::string_view cell = ffm_util::trimView(line.substr(pos, end - pos), " \t\r");
+      pos = end + 1;
+
+      if (!headerRead) {
+	std::string key(cell);
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	double SiteOverrides::* field = overrideField(cell);
+	if (labels && labelCol == std::string::npos && key == labelColumn) {
+	  labelCol = col;
 	}
+	else if (!field) {
+	  throw InputError("Problem with override table - unknown column (" + std::string(cell) + ")");
+	}
+	columns.push_back(field);
+	continue;
       }
-      continue;
-    } 
-
-    if (firstString == "meanfueldiameter") {fueldiam = atof(secondString.c_str()); continue;}
-
-    if (firstString == "meanfinenessleaves") {thickl = atof(secondString.c_str()); continue;}
 
-    //Weather variables
-    if (firstString == "airtemperature") {
-      airtemp = monteCarlo ? ffm_util::randomNormal(secondString) : stringToDouble(secondString);
-      continue;
+      if (col >= columns.size()) {
+	throw InputError("Problem with override table - too many values in row " + std::to_string(rows.size() + 1));
+      }
+      if (col == labelCol)
+	labels->emplace_back(cell);
+      else if (!cell.empty()) 
+	row.*columns[col] = stringToDouble(cell);
     }
 
-    //the other stuff
-    if (firstString == "firelinelength") {firelineLength = atof(secondString.c_str()); continue;}
-
-    //incident windspeed is converted from km/h to m/s
-    if (firstString == "incidentwindspeed") {
-      incidentWindSpeed = monteCarlo ? ffm_util::randomNormal(secondString)/3.6 : stringToDouble(secondString)/3.6;
-      continue;
-    }
- 
-    if (firstString == "overlapping"){
-      std::vector<std::string> tmp = ffm_util::split(secondString, ',');
-      if (tmp.size() == 3) {
-	strataOverlapVec.push_back(std::make_tuple(levelTypeMap.at(ffm_util::reduce(tmp[0])), 
-						   levelTypeMap.at(ffm_util::reduce(tmp[1])), 
-						   overlapTypeMap.at(ffm_util::reduce(tmp[2]))
-						   )
-				   );
+    if (headerRead) {
+      if (labels && labels->size() < rows.size() + 1) {
+	throw InputError("Problem with override table - no " + labelColumn + " in row " + std::to_string(rows.size() + 1));
       }
-      continue;
+      rows.push_back(row);
     }
+    else if (labels && labelCol == std::string::npos) {
+      throw InputError("Problem with override table - no " + labelColumn + " column");
+    }
+    headerRead = true;
+  }
 
+  return rows;
+}
 
-  }  //end of file contents
-
-  return Location(Forest(Surface(slope,dfmc,fuelload,fueldiam,thickl), stratVec, strataOverlapVec),
-		  Weather(airtemp),
-		  incidentWindSpeed,
-		  firelineLength);
-
+/*!\brief Produces header line of CSV file for override table run
+  \param loc
+  \param firstColumn The name of the column that identifies the run
+  \return A comma separated string naming the columns produced by printOverrideInputs 
+  and printMonteCarloResults
+*/
+std::string printOverrideHeader(const Location& loc, const std::string& firstColumn) {
+  const std::string sep = ",";
+  std::string str = firstColumn + sep + "Wind speed (km/h)" + sep + "Air temperature (deg C)" + sep + "Dead FMC";
+  str += sep + "Slope (deg)" + sep + "Fireline length (m)" + sep + "Surface fuel load (t/ha)";
+  for (const char* output : {"Flame length", "Flame tip height", "Flame origin height", 
+	"Flame angle", "ROS"}) {
+    str += sep + output + " Overall" + sep + output + " Surface";
+    for (const auto& st : loc.strata())
+      str += sep + output + " " + st.name();
+  }
+  str += sep + "Flame depth";
+  str += sep + "Crown fire type";
+  str += sep + "Crown run length";
+  str += sep + "Crown run velocity";
+  str += sep + "Wind reduction factor";
+  str += sep + "McArthur";
+  str += sep + "Luke & McArthur";
+  str += sep + "Van Wagner";
+  str += sep + "Van Wagner with wind";
+  str += "\n";
+  return str;
+}
 
+/*!\brief Produces inputs part of a CSV line for an override table run
+  \param row The row number within the override table
+  \param loc
+  \return A comma separated string of the values that may be overridden
+*/
+std::string printOverrideInputs(const int& row, const Location& loc) {
+  return printOverrideInputs(std::to_string(row), loc);
 }
 
+/*!\brief Produces inputs part of a CSV line for an override table run
+  \param label Identifies the run, for example the time stamp of a weather record
+  \param loc
+  \return A comma separated string of the values that may be overridden
+*/
+std::string printOverrideInputs(const std::string& label, const Location& loc) {
+  const Surface surface = loc.forest().surface();
+  std::string str = label;
+  str += "," + loc.printWindSpeed();
+  str += "," + loc.weather().printAirTempC();
+  str += "," + surface.printDeadFuelMoistCont();
+  str += "," + surface.printSlope();
+  str += "," + loc.printFirelineLength();
+  str += "," + surface.printFuelLoad();
+  return str;
+}
 
 /*!\brief Produces header part of CSV file for monte carlo run
   \param loc
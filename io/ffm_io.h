@@ -2,20 +2,73 @@
 #define FFM_IO_H
 
 #include "location.h"
+#include "site_inputs.h"
+#include "input_document.h"
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
 
+/*!\brief A problem with the contents of an input file or override table.
+
+  The message is the one that is shown to the user, see main in test.cc.
+*/
+struct InputError : public std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+int tokenizeLine(std::string_view line, std::string& key, std::string_view& value);
+
 std::vector<std::string> processLine(const std::string& line);
 
-double stringToDouble(const std::string& str);
+bool parseDouble(std::string_view str, double& value);
+
+double stringToDouble(std::string_view str);
+
+std::string readInputFile(const std::string& inPath);
+
+InputDocument parseInputText(std::string_view contents);
+
+InputDocument parseInputDocument(const std::string& inPath);
 
 std::pair<Results::OutputLevelType, int> prelimParseInputTextFile(std::string inFileName);
 
 Location parseInputTextFile(const std::string& inFileName, const bool& monteCarlo);
 
+bool parseSiteInputs(const std::string& inPath, const bool& monteCarlo, SiteInputs& inputs);
+
+bool resolveSiteInputs(const InputDocument& doc, const bool& monteCarlo, SiteInputs& inputs);
+
+bool checkSpeciesInputs(const SiteInputs::SpeciesInputs& sp);
+
+bool checkSiteInputs(const SiteInputs& inputs);
+
+Species buildSpecies(const SiteInputs::SpeciesInputs& sp, const double& dfmc);
+
+Location buildLocation(const SiteInputs& inputs);
+
+//the longest scenario document accepted by the worker and server modes, far longer
+//than any input file
+constexpr size_t MAX_DOCUMENT_LENGTH = 1 << 24;
+
+bool scenarioResults(std::string_view text, Results& res, std::string& error);
+
+double SiteOverrides::* overrideField(std::string_view name);
+
+std::vector<SiteOverrides> parseOverrideTable(const std::string& inPath, 
+					      std::vector<std::string>* labels = nullptr,
+					      const std::string& labelColumn = "");
+
 std::string printMonteCarloHeader(const Location& loc);
 
 std::string printMonteCarloInputs(const Location& loc);
 
 std::string printMonteCarloResults(const Results& res);
 
+std::string printOverrideHeader(const Location& loc, const std::string& firstColumn = "Row");
+
+std::string printOverrideInputs(const int& row, const Location& loc);
+
+std::string printOverrideInputs(const std::string& label, const Location& loc);
+
 #endif //FFM_IO_H
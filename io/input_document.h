@@ -0,0 +1,57 @@
+#ifndef INPUT_DOCUMENT_H
+#define INPUT_DOCUMENT_H
+
+#include <set>
+#include <string>
+#include <vector>
+#include "stratum.h"
+#include "forest.h"
+#include "results.h"
+
+/*!\brief The contents of an input file, read in a single pass.
+
+  An InputDocument groups the assignments of an input file into output settings,
+  site entries (surface, weather and the other site inputs) and strata, each holding
+  its species. Numeric values are kept as text so that a Monte Carlo run can draw new
+  values for every iteration without reading the file again, see resolveSiteInputs
+  in ffm_io. Entries are kept in file order, so that later assignments override
+  earlier ones when they are resolved, as they did when the file was read line by line.
+*/
+struct InputDocument {
+
+  /*!\brief A single assignment, with the key as returned by tokenizeLine*/
+  struct Entry {
+    std::string key;
+    std::string value;
+  };
+
+  /*!\brief The assignments between "begin species" and "end species"*/
+  struct SpeciesBlock {
+    std::vector<Entry> entries;
+  };
+
+  /*!\brief The assignments between "begin stratum" and "end stratum"*/
+  struct StratumBlock {
+    Stratum::LevelType level = Stratum::UNKNOWN_LEVEL;
+    std::vector<Entry> entries;
+    std::vector<SpeciesBlock> species;
+  };
+
+  //output settings
+  Results::OutputLevelType outputLevel = Results::COMPREHENSIVE;
+  int monteCarloIterations = -1;
+  std::set<Stratum::LevelType> strataWithGaps;
+
+  //the surface dead fuel moisture content is also needed by every species, so it is
+  //held apart from the other site entries and may appear anywhere in the file
+  bool hasDeadFuelMoistCont = false;
+  std::string deadFuelMoistCont;
+
+  //surface, weather and other site inputs
+  std::vector<Entry> siteEntries;
+  std::vector<Forest::StrataOverlap> strataOverlaps;
+
+  std::vector<StratumBlock> strata;
+};
+
+#endif //INPUT_DOCUMENT_H
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include "landscape.h"
+#include "ffm_io.h"
+#include "ffm_util.h"
+#include "location.h"
+
+namespace {
+
+  /*!\brief Takes the next white space separated token from str, false if there is none*/
+  bool nextToken(std::string_view& str, std::string_view& token) {
+    const char* ws = " \t\r\n";
+    size_t start = str.find_first_not_of(ws);
+    if (start == std::string_view::npos) {
+      str = std::string_view();
+      return false;
+    }
+    size_t end = std::min(str.find_first_of(ws, start), str.size());
+    token = str.substr(start, end - start);
+    str.remove_prefix(end);
+    return true;
+  }
+
+  /*!\brief A path relative to the directory of the file that names it*/
+  std::string relativeTo(const std::string& file, std::string_view path) {
+    size_t slash = file.find_last_of('/');
+    if (path.empty() || path[0] == '/' || slash == std::string::npos) return std::string(path);
+    return file.substr(0, slash + 1) + std::string(path);
+  }
+
+  /*!\brief Bits of a value, with every NaN and both zeros made alike*/
+  uint64_t canonicalBits(double value) {
+    if (std::isnan(value)) value = NAN;
+    if (value == 0) value = 0;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+}
+
+/*!\brief Reads a grid
+  \param path
+  \return The grid, an InputError is thrown if it cannot be read
+*/
+AsciiGrid AsciiGrid::read(const std::string& path) {
+  std::string contents = readInputFile(path);
+  if (contents.empty())
+    throw InputError("Problem with grid - cannot read (" + path + ")");
+
+  AsciiGrid grid;
+  std::string_view rest(contents), token, value;
+  std::string_view afterHeader = rest;
+  while (nextToken(rest, token) && isalpha(static_cast<unsigned char>(token[0]))) {
+    std::string key(token);
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    if (!nextToken(rest, value))
+      throw InputError("Problem with grid - missing value for " + key + " (" + path + ")");
+    double v = stringToDouble(value);
+    if (key == "ncols") grid.ncols = v;
+    else if (key == "nrows") grid.nrows = v;
+    else if (key == "xllcorner" || key == "xllcenter") {grid.xll = v; grid.centre = key == "xllcenter";}
+    else if (key == "yllcorner" || key == "yllcenter") grid.yll = v;
+    else if (key == "cellsize") grid.cellSize = v;
+    else if (key == "nodata_value") grid.noData = v;
+    else throw InputError("Problem with grid - unknown header " + key + " (" + path + ")");
+    afterHeader = rest;
+  }
+
+  rest = afterHeader;
+  grid.values.reserve(grid.ncols*grid.nrows);
+  while (nextToken(rest, token))
+    grid.values.push_back(stringToDouble(token));
+  if (grid.ncols == 0 || grid.nrows == 0 || grid.values.size() != grid.ncols*grid.nrows)
+    throw InputError("Problem with grid - expected ncols x nrows values (" + path + ")");
+  return grid;
+}
+
+/*!\brief Writes the grid, values in shortest form to 7 significant figures
+  \param path
+*/
+void AsciiGrid::write(const std::string& path) const {
+  std::ofstream out(path);
+  if (!out)
+    throw InputError("Problem with grid - cannot write (" + path + ")");
+
+  char buff[64];
+  out << "ncols " << ncols << "\n" << "nrows " << nrows << "\n";
+  snprintf(buff, sizeof(buff), "%.17g", xll);
+  out << (centre ? "xllcenter " : "xllcorner ") << buff << "\n";
+  snprintf(buff, sizeof(buff), "%.17g", yll);
+  out << (centre ? "yllcenter " : "yllcorner ") << buff << "\n";
+  snprintf(buff, sizeof(buff), "%.17g", cellSize);
+  out << "cellsize " << buff << "\n";
+  snprintf(buff, sizeof(buff), "%.17g", noData);
+  out << "NODATA_value " << buff << "\n";
+
+  std::string line;
+  for (size_t r = 0; r < nrows; ++r) {
+    line.clear();
+    for (size_t c = 0; c < ncols; ++c) {
+      snprintf(buff, sizeof(buff), c == 0 ? "%.7g" : " %.7g", values[r*ncols + c]);
+      line += buff;
+    }
+    line += '\n';
+    out << line;
+  }
+}
+
+/*!\brief True if other has the same rows, columns, origin and cell size*/
+bool AsciiGrid::sameShape(const AsciiGrid& other) const {
+  return ncols == other.ncols && nrows == other.nrows && xll == other.xll && yll == other.yll &&
+    cellSize == other.cellSize && centre == other.centre;
+}
+
+/*!\brief True if the value of cell i is the no data value*/
+bool AsciiGrid::isNoData(const size_t& i) const {
+  return values[i] == noData || std::isnan(values[i]);
+}
+
+const std::array<double SiteOverrides::*, 6> Landscape::FIELDS =
+  { &SiteOverrides::incidentWindSpeed, &SiteOverrides::airTemp, &SiteOverrides::deadFuelMoistCont,
+    &SiteOverrides::slope, &SiteOverrides::firelineLength, &SiteOverrides::fuelLoad };
+
+bool Landscape::CellKey::operator==(const CellKey& other) const {
+  return fuel == other.fuel && values == other.values;
+}
+
+size_t Landscape::CellKeyHash::operator()(const CellKey& key) const {
+  //FNV-1a over the fuel type and the bits of each value
+  uint64_t h = 14695981039346656037ULL;
+  auto mix = [&h](uint64_t v) {
+    for (int i = 0; i < 8; ++i, v >>= 8) {
+      h ^= v & 0xff;
+      h *= 1099511628211ULL;
+    }
+  };
+  mix(static_cast<uint64_t>(key.fuel));
+  for (const uint64_t& v : key.values) mix(v);
+  return h;
+}
+
+/*!\brief Constructor, reads the landscape file and everything it names and finds the
+  distinct cells
+  \param path The landscape file
+
+  Problems with the files are reported by throwing an InputError.
+*/
+Landscape::Landscape(const std::string& path) {
+  std::string contents = readInputFile(path);
+  if (contents.empty())
+    throw InputError("Problem with landscape file - cannot read (" + path + ")");
+
+  std::string_view rest(contents), line, value;
+  std::string key;
+  std::string fuelGridPath, fuelTablePath;
+
+  while (ffm_util::nextField(rest, '\n', line)) {
+    if (tokenizeLine(line, key, value) < 2) continue;
+
+    if (key == "fuelgrid") {fuelGridPath = relativeTo(path, value); continue;}
+    if (key == "fueltable") {fuelTablePath = relativeTo(path, value); continue;}
+
+    bool isGrid = key.size() > 4 && key.compare(key.size() - 4, 4, "grid") == 0;
+    double SiteOverrides::* field = overrideField(isGrid ? key.substr(0, key.size() - 4) : key);
+    if (!field)
+      throw InputError("Problem with landscape file - unknown parameter (" + key + ")");
+    if (isGrid)
+      grids_.push_back(std::make_pair(field, AsciiGrid::read(relativeTo(path, value))));
+    else
+      constant_.*field = stringToDouble(value);
+  }
+
+  if (fuelGridPath.empty() || fuelTablePath.empty())
+    throw InputError("Problem with landscape file - fuel grid and fuel table are required");
+
+  fuelGrid_ = AsciiGrid::read(fuelGridPath);
+  for (const auto& g : grids_)
+    if (!g.second.sameShape(fuelGrid_))
+      throw InputError("Problem with landscape file - grids differ in shape from the fuel grid");
+
+  readFuelTable(fuelTablePath);
+  index();
+}
+
+/*!\brief Reads the fuel types, one "id, input file" line each, an initial header line is allowed*/
+void Landscape::readFuelTable(const std::string& path) {
+  std::string contents = readInputFile(path);
+  std::string_view rest(contents), line, id, file;
+
+  while (ffm_util::nextField(rest, '\n', line)) {
+    line = ffm_util::trimView(line.substr(0, line.find('#')), " \t\r");
+    if (line.empty()) continue;
+    size_t comma = line.find(',');
+    id = ffm_util::trimView(line.substr(0, comma), " \t");
+    file = comma == std::string_view::npos ? std::string_view() : ffm_util::trimView(line.substr(comma + 1), " \t");
+
+    double fuel;
+    if (!parseDouble(id, fuel)) {
+      if (fuels_.empty()) continue; //header
+      throw InputError("Problem with fuel table - invalid fuel type (" + std::string(id) + ")");
+    }
+    if (file.empty())
+      throw InputError("Problem with fuel table - no input file for fuel type " + std::string(id));
+
+    InputDocument doc = parseInputDocument(relativeTo(path, file));
+    if (doc.outputLevel == Results::MONTE_CARLO)
+      throw InputError("Problem with fuel table - Monte Carlo inputs cannot be used (" + std::string(file) + ")");
+    SiteInputs inputs;
+    resolveSiteInputs(doc, false, inputs);
+    fuels_[std::lround(fuel)] = inputs;
+  }
+
+  if (fuels_.empty())
+    throw InputError("Problem with fuel table - no fuel types (" + path + ")");
+}
+
+/*!\brief Reduces the cells to their distinct combinations of inputs*/
+void Landscape::index() {
+  std::unordered_map<CellKey, uint32_t, CellKeyHash> seen;
+  const size_t n = fuelGrid_.values.size();
+  cellIndex_.assign(n, NO_CELL);
+
+  for (size_t i = 0; i < n; ++i) {
+    if (fuelGrid_.isNoData(i)) continue;
+
+    SiteOverrides overrides = constant_;
+    bool noData = false;
+    for (const auto& g : grids_) {
+      if (g.second.isNoData(i)) noData = true;
+      overrides.*g.first = g.second.values[i];
+    }
+    if (noData) continue;
+
+    CellKey key;
+    key.fuel = std::lround(fuelGrid_.values[i]);
+    if (fuels_.find(key.fuel) == fuels_.end())
+      throw InputError("Problem with landscape - fuel type " + std::to_string(key.fuel) + " is not in the fuel table");
+    for (size_t f = 0; f < FIELDS.size(); ++f)
+      key.values[f] = canonicalBits(overrides.*FIELDS[f]);
+
+    auto it = seen.emplace(key, static_cast<uint32_t>(unique_.size()));
+    if (it.second) unique_.push_back(key);
+    cellIndex_[i] = it.first->second;
+  }
+}
+
+/*!\brief Computes every distinct cell
+  \param numWorkers The number of threads to use, at least one is used
+*/
+void Landscape::run(const size_t& numWorkers) {
+  outputs_.assign(unique_.size(), CellOutputs());
+  std::atomic<size_t> next(0);
+  auto work = [this, &next]() {
+    for (size_t i; (i = next++) < unique_.size(); )
+      outputs_[i] = compute(unique_[i]);
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < std::min(std::max<size_t>(numWorkers, 1), unique_.size()); ++t)
+    threads.emplace_back(work);
+  work();
+  for (std::thread& t : threads) t.join();
+}
+
+Landscape::CellOutputs Landscape::compute(const CellKey& key) const {
+  SiteInputs inputs = fuels_.at(key.fuel);
+  SiteOverrides overrides;
+  for (size_t f = 0; f < FIELDS.size(); ++f)
+    memcpy(&(overrides.*FIELDS[f]), &key.values[f], sizeof(double));
+  overrides.apply(inputs);
+
+  CellOutputs out;
+  if (!checkSiteInputs(inputs)) return out;
+
+  //the crown fire type is one of the Monte Carlo columns, not a basic output
+  Results res = buildLocation(inputs).results(Results::MONTE_CARLO);
+  out.valid = true;
+  out.ros = res.ros()*3.6;
+  out.flameHeight = res.flameTipHeight();
+  out.crownFireType = res.crownFireType();
+  return out;
+}
+
+/*!\brief Writes the output grids
+  \param outPrefix The grids written are outPrefix followed by _ros.asc (km/h),
+  _flame_height.asc (m, the height of the flame tip) and _crown_fire_type.asc
+  (0 unclassified, 1 passive, 2 active)
+*/
+void Landscape::write(const std::string& outPrefix) const {
+  AsciiGrid ros = fuelGrid_, height = fuelGrid_, crown = fuelGrid_;
+  for (size_t i = 0; i < cellIndex_.size(); ++i) {
+    if (cellIndex_[i] == NO_CELL || !outputs_[cellIndex_[i]].valid) {
+      ros.values[i] = height.values[i] = crown.values[i] = fuelGrid_.noData;
+      continue;
+    }
+    const CellOutputs& out = outputs_[cellIndex_[i]];
+    ros.values[i] = out.ros;
+    height.values[i] = out.flameHeight;
+    crown.values[i] = out.crownFireType;
+  }
+  ros.write(outPrefix + "_ros.asc");
+  height.write(outPrefix + "_flame_height.asc");
+  crown.write(outPrefix + "_crown_fire_type.asc");
+}
+
+/*!\brief The number of cells in the landscape*/
+size_t Landscape::numCells() const {return cellIndex_.size();}
+
+/*!\brief The number of distinct combinations of inputs to be computed*/
+size_t Landscape::numUnique() const {return unique_.size();}
+
+/*!\brief The number of distinct combinations whose inputs failed the checks, after run*/
+size_t Landscape::numInvalid() const {
+  return std::count_if(outputs_.begin(), outputs_.end(), [](const CellOutputs& o){return !o.valid;});
+}
@@ -0,0 +1,111 @@
+#ifndef LANDSCAPE_H
+#define LANDSCAPE_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "results.h"
+#include "site_inputs.h"
+
+/*!\brief A raster in ESRI ASCII grid format.
+
+  The header gives ncols, nrows, xllcorner (or xllcenter), yllcorner (or yllcenter),
+  cellsize and optionally NODATA_value, which defaults to -9999. Values follow in rows
+  from north to south and are held in that order.
+*/
+struct AsciiGrid {
+  size_t ncols = 0, nrows = 0;
+  double xll = 0, yll = 0, cellSize = 1;
+  bool centre = false;
+  double noData = -9999;
+  std::vector<double> values;
+
+  static AsciiGrid read(const std::string& path);
+  void write(const std::string& path) const;
+
+  bool sameShape(const AsciiGrid& other) const;
+  bool isNoData(const size_t& i) const;
+};
+
+/*!\brief Runs the model over a gridded landscape.
+
+  A landscape file has the assignment syntax of an input file and gives
+
+    fuel grid = path of a grid of fuel type ids
+    fuel table = path of a CSV table of fuel type id and input file path
+
+  together with any of the overrides of an override table (incident wind speed, air
+  temperature, surface dead fuel moisture content, slope, fireline length and fuel
+  load tonnes per hectare), each either as a single value for every cell, for example
+  "incident wind speed = 20", or as a grid, for example "slope grid = slope.asc". Grids
+  must have the shape of the fuel grid. Relative paths are taken from the directory of
+  the file in which they appear. The input files of the fuel table give everything
+  else, and may not be Monte Carlo inputs.
+
+  Cells are reduced to the distinct combinations of fuel type and override values, each
+  of which is computed once, with the combinations shared out over worker threads. A
+  cell is left as no data if the fuel grid or any override grid has no data there, or
+  if its inputs fail the checks of the input file parser.
+*/
+class Landscape {
+public:
+
+  //constructors
+
+  explicit Landscape(const std::string& path);
+
+  //accessors
+
+  size_t numCells() const;
+  size_t numUnique() const;
+  size_t numInvalid() const;
+
+  //other methods
+
+  void run(const size_t& numWorkers);
+  void write(const std::string& outPrefix) const;
+
+private:
+
+  /*!\brief A distinct combination of fuel type and overrides, held as bit patterns so
+    that unset (NaN) values compare equal
+  */
+  struct CellKey {
+    long fuel;
+    std::array<uint64_t, 6> values;
+    bool operator==(const CellKey& other) const;
+  };
+
+  struct CellKeyHash {
+    size_t operator()(const CellKey& key) const;
+  };
+
+  /*!\brief The outputs written for each cell*/
+  struct CellOutputs {
+    bool valid = false;
+    double ros = 0;
+    double flameHeight = 0;
+    Results::CrownFireType crownFireType = Results::UNCLASSIFIED;
+  };
+
+  static const std::array<double SiteOverrides::*, 6> FIELDS;
+
+  AsciiGrid fuelGrid_;
+  std::map<long, SiteInputs> fuels_;
+  SiteOverrides constant_;
+  std::vector<std::pair<double SiteOverrides::*, AsciiGrid>> grids_;
+
+  static constexpr uint32_t NO_CELL = UINT32_MAX;
+  std::vector<uint32_t> cellIndex_;
+  std::vector<CellKey> unique_;
+  std::vector<CellOutputs> outputs_;
+
+  void readFuelTable(const std::string& path);
+  void index();
+  CellOutputs compute(const CellKey& key) const;
+};
+
+#endif //LANDSCAPE_H
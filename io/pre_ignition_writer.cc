@@ -0,0 +1,57 @@
+#include <cstdio>
+
+#include "pre_ignition_writer.h"
+
+namespace {
+
+  //quoted as needed for CSV
+  std::string csvField(const std::string& str) {
+    if (str.find_first_of(",\"\n\r") == std::string::npos) return str;
+    std::string out = "\"";
+    for (const char c : str) {
+      if (c == '"') out += '"';
+      out += c;
+    }
+    return out + "\"";
+  }
+
+}
+
+/*!\brief Constructor, which writes the header line
+  \param out The stream written to, which must outlive the writer
+*/
+PreIgnitionWriter::PreIgnitionWriter(std::ostream& out) : out_(out) {
+  out_ << "site,row,path,level,species,record,flame_length_m,depth_ignited_m,"
+       << "distance_to_flame_m,temperature_c,drying_factor,duration_s,idt_s\n";
+}
+
+/*!\brief Sets the site and row of the lines that follow
+  \param site
+  \param row The Monte Carlo iteration or table row, omitted if negative
+*/
+void PreIgnitionWriter::site(const std::string& site, const int& row) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  site_ = csvField(site);
+  row_ = row;
+}
+
+/*!\brief Writes one line for the record
+  \param path
+  \param data
+*/
+void PreIgnitionWriter::observe(const IgnitionPath& path, const PreIgnitionData& data) {
+  char buff[200];
+  bool preHeating = data.type() == PreIgnitionData::Type::PREHEATING;
+  int n = snprintf(buff, sizeof(buff), ",%s,%.17g,%.17g,%.17g,%.17g,%.17g,",
+		   PreIgnitionData::getTypeLabel(data.type()).c_str(), data.flameLength(),
+		   data.depthIgnited(), data.distanceToFlame(), data.temperature(),
+		   data.dryingFactor());
+  snprintf(buff + n, sizeof(buff) - n, preHeating ? "%.17g," : ",%.17g",
+	   preHeating ? data.duration() : data.idt());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  out_ << site_ << ",";
+  if (row_ >= 0) out_ << row_;
+  out_ << "," << ignitionPathTypeStringMap.at(path.type()) << "," << levelStringMap.at(path.level())
+       << "," << csvField(path.species().name()) << buff << "\n";
+}
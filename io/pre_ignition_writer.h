@@ -0,0 +1,48 @@
+#ifndef PRE_IGNITION_WRITER_H
+#define PRE_IGNITION_WRITER_H
+
+#include <mutex>
+#include <ostream>
+#include <string>
+#include "pre_ignition_observer.h"
+
+/*!\brief Streams pre-ignition data to a CSV file as the ignition paths are computed
+
+  Attached to a Location with Location::preIgnitionObserver(), the writer adds a line
+  for each PreIgnitionData record, in place of keeping the records in the paths. The
+  columns are
+
+    site, row, path, level, species, record, flame_length_m, depth_ignited_m,
+    distance_to_flame_m, temperature_c, drying_factor, duration_s, idt_s
+
+  where site and row are those last given to site(), row is empty when negative,
+  duration_s is empty for incident records and idt_s is empty for pre-heating records.
+  Lines are written whole under a lock, so one writer may serve several threads.
+*/
+class PreIgnitionWriter : public PreIgnitionObserver {
+public:
+
+  //constructors
+
+  explicit PreIgnitionWriter(std::ostream& out);
+
+  PreIgnitionWriter(const PreIgnitionWriter&) = delete;
+  PreIgnitionWriter& operator=(const PreIgnitionWriter&) = delete;
+
+  //mutators
+
+  void site(const std::string& site, const int& row = -1);
+
+  //other methods
+
+  void observe(const IgnitionPath& path, const PreIgnitionData& data) override;
+
+private:
+
+  std::ostream& out_;
+  std::mutex mutex_;
+  std::string site_;
+  int row_ = -1;
+};
+
+#endif //PRE_IGNITION_WRITER_H
@@ -0,0 +1,353 @@
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+#include "result_emitter.h"
+#include "ffm_numerics.h"
+
+/*
+  Schema version 2. Every record has, in order:
+
+    schema, site, row (null or empty when not applicable),
+    ros_kmh, flame_length_m, flame_angle_deg, flame_tip_height_m, flame_origin_height_m,
+    flame_depth_m, surface_ros_kmh, surface_flame_length_m, surface_flame_height_m,
+    surface_flame_angle_deg, crown_fire_type, crown_run_length_m, crown_run_velocity_kmh,
+    wind_reduction_factor, scorch_height_mcarthur_m, scorch_height_luke_mcarthur_m,
+    scorch_height_van_wagner_m, scorch_height_van_wagner_with_wind_m
+
+  followed by the stratum fields
+
+    ros_kmh, flame_length_m, flame_angle_deg, flame_tip_height_m, flame_origin_height_m,
+    proportion_burnt
+
+  which in CSV are repeated for each level with the level name as prefix (for example
+  elevated_ros_kmh) and in NDJSON are given for each stratum present, along with its
+  level and species_flame_tip_heights_m, in the array "strata".
+
+  A CSV record ends with an error column, empty unless the site could not be computed,
+  when it holds the message and every result field is empty. An NDJSON record for such
+  a site holds only schema, site, row and error.
+*/
+
+namespace {
+
+  //the fields of a record, in order, before the stratum fields
+  const char* const FIELDS[] = {"schema", "site", "row", "ros_kmh", "flame_length_m",
+				"flame_angle_deg", "flame_tip_height_m", "flame_origin_height_m",
+				"flame_depth_m", "surface_ros_kmh", "surface_flame_length_m",
+				"surface_flame_height_m", "surface_flame_angle_deg", "crown_fire_type",
+				"crown_run_length_m", "crown_run_velocity_kmh", "wind_reduction_factor",
+				"scorch_height_mcarthur_m", "scorch_height_luke_mcarthur_m",
+				"scorch_height_van_wagner_m", "scorch_height_van_wagner_with_wind_m"};
+
+  //the fields that identify a record, which begin FIELDS
+  const size_t NUM_KEY_FIELDS = 3;
+
+  const char* const STRATUM_FIELDS[] = {"ros_kmh", "flame_length_m", "flame_angle_deg",
+					"flame_tip_height_m", "flame_origin_height_m",
+					"proportion_burnt"};
+
+  const Stratum::LevelType LEVELS[] = {Stratum::NEAR_SURFACE, Stratum::ELEVATED,
+				       Stratum::MID_STOREY, Stratum::CANOPY};
+
+  const char* levelName(const Stratum::LevelType& level) {
+    switch (level) {
+    case Stratum::NEAR_SURFACE: return "near_surface";
+    case Stratum::ELEVATED: return "elevated";
+    case Stratum::MID_STOREY: return "mid_storey";
+    case Stratum::CANOPY: return "canopy";
+    default: return "unknown";
+    }
+  }
+
+  const char* crownFireTypeName(const Results::CrownFireType& type) {
+    switch (type) {
+    case Results::PASSIVE: return "passive";
+    case Results::ACTIVE: return "active";
+    default: return "unclassified";
+    }
+  }
+
+}
+
+/*!\brief Constructor
+  \param out The stream to which records are written
+  \param format
+*/
+ResultEmitter::ResultEmitter(std::ostream& out, const FormatType& format)
+  : out_(out), format_(format) {}
+
+/*!\brief Destructor, writes out anything still buffered*/
+ResultEmitter::~ResultEmitter() {flush();}
+
+/*!\brief Writes one record
+  \param res
+  \param site An identifier for the site, typically its input file
+  \param row The row or iteration number, if negative then the row field is left empty
+
+  In CSV format the header line is written before the first record.
+*/
+void ResultEmitter::emit(const Results& res, std::string_view site, const int& row) {
+  if (format_ == CSV && !headerWritten_) writeHeader();
+
+  if (format_ == NDJSON) putChar('{');
+  beginField("schema", true);
+  putInt(SCHEMA_VERSION);
+  beginField("site");
+  putString(site);
+  beginField("row");
+  if (row >= 0)
+    putInt(row);
+  else if (format_ == NDJSON)
+    putRaw("null");
+
+  beginField("ros_kmh");
+  putNumber(res.ros()*3.6);
+  beginField("flame_length_m");
+  putNumber(res.flameLength());
+  beginField("flame_angle_deg");
+  putNumber(res.flameAngle()*180/PI);
+  beginField("flame_tip_height_m");
+  putNumber(res.flameTipHeight());
+  beginField("flame_origin_height_m");
+  putNumber(res.flameOriginHeight());
+  beginField("flame_depth_m");
+  putNumber(res.flameDepth());
+  beginField("surface_ros_kmh");
+  putNumber(res.surfaceROS()*3.6);
+  beginField("surface_flame_length_m");
+  putNumber(res.surfaceFlameLength());
+  beginField("surface_flame_height_m");
+  putNumber(res.surfaceFlameHeight());
+  beginField("surface_flame_angle_deg");
+  putNumber(res.surfaceFlameAngle()*180/PI);
+  beginField("crown_fire_type");
+  putString(crownFireTypeName(res.crownFireType()));
+  beginField("crown_run_length_m");
+  putNumber(res.crownRunLength());
+  beginField("crown_run_velocity_kmh");
+  putNumber(res.crownRunVelocity()*3.6);
+  beginField("wind_reduction_factor");
+  putNumber(res.windReductionFactor());
+  beginField("scorch_height_mcarthur_m");
+  putNumber(res.scorchHeightMcarthur());
+  beginField("scorch_height_luke_mcarthur_m");
+  putNumber(res.scorchHeightLukeMcarthur());
+  beginField("scorch_height_van_wagner_m");
+  putNumber(res.scorchHeightVanWagner());
+  beginField("scorch_height_van_wagner_with_wind_m");
+  putNumber(res.scorchHeightVanWagnerWithWind());
+
+  const std::vector<StratumResults>& strata = res.strataResults();
+  if (format_ == CSV) {
+    for (const Stratum::LevelType& level : LEVELS) {
+      const StratumResults* found = nullptr;
+      for (const StratumResults& sr : strata)
+	if (sr.level() == level) found = &sr;
+      putStratum(found);
+    }
+    beginField("error");
+    putChar('\n');
+  }
+  else {
+    beginField("strata");
+    putChar('[');
+    for (size_t i = 0; i < strata.size(); ++i) {
+      if (i > 0) putChar(',');
+      putChar('{');
+      beginField("level", true);
+      putString(levelName(strata[i].level()));
+      putStratum(&strata[i]);
+      beginField("species_flame_tip_heights_m");
+      putChar('{');
+      bool first = true;
+      for (const auto& sp : strata[i].speciesFlameTipHeights()) {
+	if (!first) putChar(',');
+	first = false;
+	putString(sp.first);
+	putChar(':');
+	putNumber(sp.second);
+      }
+      putRaw("}}");
+    }
+    putRaw("]}\n");
+  }
+}
+
+/*!\brief Writes a record for a site that could not be computed
+  \param message
+  \param site
+  \param row The row or request number, if negative then the row field is left empty
+
+  In NDJSON the record holds schema, site, row and "error". In CSV the result fields 
+  are left empty and the message is given in the error column.
+*/
+void ResultEmitter::emitError(std::string_view message, std::string_view site, const int& row) {
+  if (format_ == CSV && !headerWritten_) writeHeader();
+
+  if (format_ == NDJSON) putChar('{');
+  beginField("schema", true);
+  putInt(SCHEMA_VERSION);
+  beginField("site");
+  putString(site);
+  beginField("row");
+  if (row >= 0)
+    putInt(row);
+  else if (format_ == NDJSON)
+    putRaw("null");
+
+  if (format_ == NDJSON) {
+    beginField("error");
+    putString(message);
+    putRaw("}\n");
+    return;
+  }
+
+  size_t numResultFields = std::size(FIELDS) - NUM_KEY_FIELDS + 
+    std::size(LEVELS)*std::size(STRATUM_FIELDS);
+  for (size_t i = 0; i < numResultFields; ++i) putChar(',');
+  beginField("error");
+  putString(message);
+  putChar('\n');
+}
+
+/*!\brief Writes out the buffer*/
+void ResultEmitter::flush() {
+  if (used_ > 0) out_.write(buffer_.data(), used_);
+  used_ = 0;
+  out_.flush();
+}
+
+/*!\brief Parses the name of a format
+  \param name "ndjson" or "csv"
+  \param format Set to the corresponding format
+  \return False if name is not recognised
+*/
+bool ResultEmitter::formatType(std::string_view name, FormatType& format) {
+  if (name == "ndjson" || name == "json")
+    format = NDJSON;
+  else if (name == "csv")
+    format = CSV;
+  else
+    return false;
+  return true;
+}
+
+/*!\brief Writes the CSV header line*/
+void ResultEmitter::writeHeader() {
+  bool first = true;
+  for (const char* f : FIELDS) {
+    if (!first) putChar(',');
+    first = false;
+    putRaw(f);
+  }
+  for (const Stratum::LevelType& level : LEVELS)
+    for (const char* f : STRATUM_FIELDS) {
+      putChar(',');
+      putRaw(levelName(level));
+      putChar('_');
+      putRaw(f);
+    }
+  putRaw(",error\n");
+  headerWritten_ = true;
+}
+
+/*!\brief Starts a field, writing the separator and, for NDJSON, the key*/
+void ResultEmitter::beginField(const char* name, const bool& first) {
+  if (!first) putChar(',');
+  if (format_ == NDJSON) {
+    putChar('"');
+    putRaw(name);
+    putRaw("\":");
+  }
+}
+
+inline void ResultEmitter::putChar(const char& c) {
+  if (used_ == buffer_.size()) flush();
+  buffer_[used_++] = c;
+}
+
+void ResultEmitter::putRaw(std::string_view str) {
+  while (!str.empty()) {
+    if (used_ == buffer_.size()) flush();
+    size_t n = std::min(str.size(), buffer_.size() - used_);
+    memcpy(buffer_.data() + used_, str.data(), n);
+    used_ += n;
+    str.remove_prefix(n);
+  }
+}
+
+/*!\brief Writes a string value, escaped for JSON or quoted for CSV as needed*/
+void ResultEmitter::putString(std::string_view str) {
+  if (format_ == CSV) {
+    if (str.find_first_of(",\"\n\r") == std::string_view::npos) {
+      putRaw(str);
+      return;
+    }
+    putChar('"');
+    for (const char c : str) {
+      if (c == '"') putChar('"');
+      putChar(c);
+    }
+    putChar('"');
+    return;
+  }
+
+  const char* hex = "0123456789abcdef";
+  putChar('"');
+  for (const char c : str) {
+    unsigned char u = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\') {
+      putChar('\\');
+      putChar(c);
+    }
+    else if (u < 0x20) {
+      putRaw("\\u00");
+      putChar(hex[u >> 4]);
+      putChar(hex[u & 0xf]);
+    }
+    else
+      putChar(c);
+  }
+  putChar('"');
+}
+
+/*!\brief Writes a number in its shortest exact form, non-finite values are null or empty*/
+void ResultEmitter::putNumber(const double& value) {
+  if (!std::isfinite(value)) {
+    if (format_ == NDJSON) putRaw("null");
+    return;
+  }
+  //enough for any double in shortest form
+  if (buffer_.size() - used_ < 32) flush();
+  auto res = std::to_chars(buffer_.data() + used_, buffer_.data() + buffer_.size(), value);
+  used_ = res.ptr - buffer_.data();
+}
+
+void ResultEmitter::putInt(const int& value) {
+  if (buffer_.size() - used_ < 16) flush();
+  auto res = std::to_chars(buffer_.data() + used_, buffer_.data() + buffer_.size(), value);
+  used_ = res.ptr - buffer_.data();
+}
+
+/*!\brief Writes the fields of a stratum, or empty CSV cells if sr is null*/
+void ResultEmitter::putStratum(const StratumResults* sr) {
+  if (!sr) {
+    for (size_t i = 0; i < sizeof(STRATUM_FIELDS)/sizeof(STRATUM_FIELDS[0]); ++i) putChar(',');
+    return;
+  }
+  beginField(STRATUM_FIELDS[0]);
+  putNumber(sr->ros()*3.6);
+  beginField(STRATUM_FIELDS[1]);
+  putNumber(sr->flameLength());
+  beginField(STRATUM_FIELDS[2]);
+  putNumber(sr->flameAngle()*180/PI);
+  beginField(STRATUM_FIELDS[3]);
+  putNumber(sr->flameTipHeight());
+  beginField(STRATUM_FIELDS[4]);
+  putNumber(sr->flameOriginHeight());
+  beginField(STRATUM_FIELDS[5]);
+  putNumber(sr->proportionBurnt());
+}
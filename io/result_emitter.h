@@ -0,0 +1,68 @@
+#ifndef RESULT_EMITTER_H
+#define RESULT_EMITTER_H
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include "results.h"
+#include "stratum_results.h"
+
+/*!\brief Writes Results as structured records, one line per record, for machine ingestion.
+
+  Two formats are supported, newline delimited JSON (one object per line) and CSV with
+  a header line and a fixed set of columns. The fields are the same for every record
+  whatever the output level or the strata present, and are listed in result_emitter.cc.
+  Field names carry their units (ros_kmh, flame_angle_deg, ...), values are in the
+  units of the text report and are written in full precision, that is in the shortest
+  form that reads back to the same double. In CSV each stratum level has its own block
+  of columns, which is left empty when the stratum is absent, and species flame tip
+  heights are omitted. In NDJSON the strata present are listed under "strata".
+
+  Fields are formatted straight into a fixed buffer which is written to the output
+  stream when full and when the emitter is flushed or destroyed. No strings are built.
+*/
+class ResultEmitter {
+public:
+
+  /*!\brief Record format*/
+  enum FormatType {NDJSON, CSV};
+
+  /*!\brief Incremented whenever fields are added, removed or reordered*/
+  static constexpr int SCHEMA_VERSION = 2;
+
+  //constructors
+
+  ResultEmitter(std::ostream& out, const FormatType& format);
+  ~ResultEmitter();
+
+  ResultEmitter(const ResultEmitter&) = delete;
+  ResultEmitter& operator=(const ResultEmitter&) = delete;
+
+  //other methods
+
+  void emit(const Results& res, std::string_view site, const int& row = -1);
+  void emitError(std::string_view message, std::string_view site, const int& row = -1);
+  void flush();
+
+  static bool formatType(std::string_view name, FormatType& format);
+
+private:
+
+  std::ostream& out_;
+  FormatType format_;
+  bool headerWritten_ = false;
+  std::array<char, 1 << 16> buffer_;
+  size_t used_ = 0;
+
+  void writeHeader();
+  void beginField(const char* name, const bool& first = false);
+  void putChar(const char& c);
+  void putRaw(std::string_view str);
+  void putString(std::string_view str);
+  void putNumber(const double& value);
+  void putInt(const int& value);
+  void putStratum(const StratumResults* sr);
+};
+
+#endif //RESULT_EMITTER_H
@@ -0,0 +1,331 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FFM_HAVE_MMAP
+#endif
+
+#include "scenario_file.h"
+
+namespace {
+
+  const char MAGIC[8] = {'F','F','M','S','C','E','N','\0'};
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+  const size_t HEADER_SIZE = sizeof(MAGIC) + 2*sizeof(uint32_t) + 2*sizeof(uint64_t);
+
+  void corrupt(const std::string& path) {
+    throw InputError("Problem with scenario file - " + path + " is truncated or corrupt");
+  }
+
+  //appends values to a buffer in native byte order
+  class Encoder {
+  public:
+    std::string buffer;
+
+    template<typename T> void put(const T& value) {
+      buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void putDouble(const double& value) {put(value);}
+    void putInt(const int& value) {put(static_cast<int32_t>(value));}
+    void putCount(const size_t& value) {put(static_cast<uint32_t>(value));}
+    void putString(const std::string& value) {
+      putCount(value.size());
+      buffer.append(value);
+    }
+  };
+
+  //reads values from a region of memory, throwing if the region is overrun
+  class Decoder {
+  public:
+    Decoder(const char* begin, const char* end, const std::string& path)
+      : pos_(begin), end_(end), path_(path) {}
+
+    template<typename T> T get() {
+      if (end_ - pos_ < static_cast<std::ptrdiff_t>(sizeof(T))) corrupt(path_);
+      T value;
+      memcpy(&value, pos_, sizeof(T));
+      pos_ += sizeof(T);
+      return value;
+    }
+    double getDouble() {return get<double>();}
+    int getInt() {return get<int32_t>();}
+    size_t getCount() {return get<uint32_t>();}
+    std::string getString() {
+      size_t n = getCount();
+      if (static_cast<size_t>(end_ - pos_) < n) corrupt(path_);
+      std::string value(pos_, n);
+      pos_ += n;
+      return value;
+    }
+    bool atEnd() const {return pos_ == end_;}
+
+  private:
+    const char* pos_;
+    const char* end_;
+    const std::string& path_;
+  };
+
+  /*
+    A site record is the site name followed by the members of SiteInputs in
+    declaration order. Enumerations are stored as int32 and the lengths of
+    strings and vectors as uint32.
+  */
+  void encodeSite(Encoder& enc, const std::string& name, const SiteInputs& site) {
+    enc.putString(name);
+    enc.putInt(site.outputLevel);
+    enc.putDouble(site.slope);
+    enc.putDouble(site.deadFuelMoistCont);
+    enc.putDouble(site.fuelLoad);
+    enc.putDouble(site.meanFuelDiameter);
+    enc.putDouble(site.meanFinenessLeaves);
+    enc.putDouble(site.airTemp);
+    enc.putDouble(site.incidentWindSpeed);
+    enc.putDouble(site.firelineLength);
+
+    enc.putCount(site.strata.size());
+    for (const auto& st : site.strata) {
+      enc.putInt(st.level);
+      enc.putDouble(st.plantSep);
+      enc.putInt(st.include);
+      enc.putCount(st.species.size());
+      for (const auto& sp : st.species) {
+	enc.putString(sp.name);
+	enc.putDouble(sp.composition);
+	enc.putDouble(sp.hc);
+	enc.putDouble(sp.he);
+	enc.putDouble(sp.ht);
+	enc.putDouble(sp.hp);
+	enc.putDouble(sp.w);
+	enc.putDouble(sp.liveLeafMoisture);
+	enc.putDouble(sp.propDead);
+	enc.putDouble(sp.silFreeAshCont);
+	enc.putDouble(sp.ignitTemp);
+	enc.putInt(sp.leafForm);
+	enc.putDouble(sp.leafThick);
+	enc.putDouble(sp.leafWidth);
+	enc.putDouble(sp.leafLength);
+	enc.putDouble(sp.leafSep);
+	enc.putDouble(sp.stemOrder);
+	enc.putDouble(sp.clumpDiam);
+	enc.putDouble(sp.clumpSep);
+      }
+    }
+
+    enc.putCount(site.strataOverlaps.size());
+    for (const auto& so : site.strataOverlaps) {
+      enc.putInt(std::get<0>(so));
+      enc.putInt(std::get<1>(so));
+      enc.putInt(std::get<2>(so));
+    }
+  }
+
+  SiteInputs decodeSite(Decoder& dec) {
+    SiteInputs site;
+    dec.getString(); //name
+    site.outputLevel = static_cast<Results::OutputLevelType>(dec.getInt());
+    site.slope = dec.getDouble();
+    site.deadFuelMoistCont = dec.getDouble();
+    site.fuelLoad = dec.getDouble();
+    site.meanFuelDiameter = dec.getDouble();
+    site.meanFinenessLeaves = dec.getDouble();
+    site.airTemp = dec.getDouble();
+    site.incidentWindSpeed = dec.getDouble();
+    site.firelineLength = dec.getDouble();
+
+    site.strata.resize(dec.getCount());
+    for (auto& st : site.strata) {
+      st.level = static_cast<Stratum::LevelType>(dec.getInt());
+      st.plantSep = dec.getDouble();
+      st.include = dec.getInt() != 0;
+      st.species.resize(dec.getCount());
+      for (auto& sp : st.species) {
+	sp.name = dec.getString();
+	sp.composition = dec.getDouble();
+	sp.hc = dec.getDouble();
+	sp.he = dec.getDouble();
+	sp.ht = dec.getDouble();
+	sp.hp = dec.getDouble();
+	sp.w = dec.getDouble();
+	sp.liveLeafMoisture = dec.getDouble();
+	sp.propDead = dec.getDouble();
+	sp.silFreeAshCont = dec.getDouble();
+	sp.ignitTemp = dec.getDouble();
+	sp.leafForm = static_cast<Species::LeafFormType>(dec.getInt());
+	sp.leafThick = dec.getDouble();
+	sp.leafWidth = dec.getDouble();
+	sp.leafLength = dec.getDouble();
+	sp.leafSep = dec.getDouble();
+	sp.stemOrder = dec.getDouble();
+	sp.clumpDiam = dec.getDouble();
+	sp.clumpSep = dec.getDouble();
+      }
+    }
+
+    site.strataOverlaps.resize(dec.getCount());
+    for (auto& so : site.strataOverlaps) {
+      Stratum::LevelType first = static_cast<Stratum::LevelType>(dec.getInt());
+      Stratum::LevelType second = static_cast<Stratum::LevelType>(dec.getInt());
+      Forest::StrataOverlapType type = static_cast<Forest::StrataOverlapType>(dec.getInt());
+      so = std::make_tuple(first, second, type);
+    }
+    return site;
+  }
+
+}
+
+/*!\brief Opens a scenario file
+  \param path
+
+  The file is memory mapped where the platform allows, otherwise it is read into
+  memory. An InputError is thrown if the file cannot be opened, is not a scenario file,
+  has a version or byte order other than those written by this program or has an 
+  index that does not fit the file.
+*/
+ScenarioFile::ScenarioFile(const std::string& path) : path_(path) {
+#ifdef FFM_HAVE_MMAP
+  int fd = open(path.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      data_ = static_cast<const char*>(p);
+      size_ = st.st_size;
+      mapped_ = true;
+    }
+  }
+  if (fd >= 0) close(fd);
+#endif
+  if (!data_) {
+    std::ifstream inFile(path, std::ios::binary);
+    buffer_.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+
+  //the destructor does not run if the constructor throws
+  try {
+    if (size_ < HEADER_SIZE || memcmp(data_, MAGIC, sizeof(MAGIC)) != 0)
+      throw InputError("Problem with scenario file - " + path + " is not a scenario file");
+    Decoder header(data_ + sizeof(MAGIC), data_ + HEADER_SIZE, path_);
+    uint32_t version = header.get<uint32_t>();
+    uint32_t byteOrder = header.get<uint32_t>();
+    if (version != VERSION || byteOrder != BYTE_ORDER_MARK)
+      throw InputError("Problem with scenario file - " + path + " has version " + std::to_string(version) +
+		       " or byte order unsupported by this program");
+    uint64_t numSites = header.get<uint64_t>();
+    uint64_t indexOffset = header.get<uint64_t>();
+    //numSites is compared by division, since a corrupt count could overflow the product
+    if (indexOffset < HEADER_SIZE || indexOffset > size_ ||
+	numSites > (size_ - indexOffset)/sizeof(uint64_t) ||
+	(size_ - indexOffset) != numSites*sizeof(uint64_t)) corrupt(path_);
+
+    Decoder index(data_ + indexOffset, data_ + size_, path_);
+    offsets_.resize(numSites);
+    for (auto& off : offsets_) {
+      off = index.get<uint64_t>();
+      if (off < HEADER_SIZE || off > indexOffset) corrupt(path_);
+    }
+  }
+  catch (...) {
+    unmap();
+    throw;
+  }
+}
+
+/*!\brief Destructor, unmaps the file*/
+ScenarioFile::~ScenarioFile() {
+  unmap();
+}
+
+/*!\brief Name of a site
+  \param i The index of the site, 0 <= i < numSites()
+  \return The name recorded for site i when the file was compiled
+*/
+std::string ScenarioFile::siteName(const size_t& i) const {
+  const char *begin, *end;
+  siteBounds(i, begin, end);
+  Decoder dec(begin, end, path_);
+  return dec.getString();
+}
+
+/*!\brief Inputs for a site
+  \param i The index of the site, 0 <= i < numSites()
+  \return The inputs of site i
+*/
+SiteInputs ScenarioFile::siteInputs(const size_t& i) const {
+  const char *begin, *end;
+  siteBounds(i, begin, end);
+  Decoder dec(begin, end, path_);
+  SiteInputs site = decodeSite(dec);
+  if (!dec.atEnd()) corrupt(path_);
+  return site;
+}
+
+/*!\brief Checks whether a file is a scenario file
+  \param path
+  \return True if the file at path starts with the scenario file magic number
+*/
+bool ScenarioFile::isScenarioFile(const std::string& path) {
+  std::ifstream inFile(path, std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  return inFile.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+/*!\brief Writes a scenario file
+  \param path
+  \param siteNames The name of each site, typically the input file it was read from
+  \param sites The inputs of each site
+
+  An InputError is thrown if the file cannot be written.
+*/
+void ScenarioFile::write(const std::string& path,
+			 const std::vector<std::string>& siteNames,
+			 const std::vector<SiteInputs>& sites) {
+  Encoder enc;
+  enc.buffer.append(MAGIC, sizeof(MAGIC));
+  enc.put(VERSION);
+  enc.put(BYTE_ORDER_MARK);
+  enc.put(static_cast<uint64_t>(sites.size()));
+  enc.put(static_cast<uint64_t>(0)); //index offset, filled in below
+
+  std::vector<uint64_t> offsets;
+  offsets.reserve(sites.size());
+  for (size_t i = 0; i < sites.size(); ++i) {
+    offsets.push_back(enc.buffer.size());
+    encodeSite(enc, siteNames.at(i), sites[i]);
+  }
+  uint64_t indexOffset = enc.buffer.size();
+  memcpy(&enc.buffer[HEADER_SIZE - sizeof(uint64_t)], &indexOffset, sizeof(uint64_t));
+  for (const auto& off : offsets) enc.put(off);
+
+  std::ofstream outFile(path, std::ios::binary);
+  outFile.write(enc.buffer.data(), enc.buffer.size());
+  if (!outFile)
+    throw InputError("Problem writing scenario file " + path);
+}
+
+/*!\brief Unmaps the file, if it was mapped*/
+void ScenarioFile::unmap() {
+#ifdef FFM_HAVE_MMAP
+  if (mapped_) munmap(const_cast<char*>(data_), size_);
+  mapped_ = false;
+#endif
+}
+
+/*!\brief Location of a site record within the file*/
+void ScenarioFile::siteBounds(const size_t& i, const char*& begin, const char*& end) const {
+  begin = data_ + offsets_.at(i);
+  end = data_ + (i + 1 < offsets_.size() ? offsets_[i + 1] :
+		 offsets_.empty() ? 0 : size_ - offsets_.size()*sizeof(uint64_t));
+  if (end < begin) corrupt(path_);
+}
@@ -0,0 +1,70 @@
+#ifndef SCENARIO_FILE_H
+#define SCENARIO_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "location.h"
+#include "site_inputs.h"
+#include "ffm_io.h"
+
+/*!\brief A compiled scenario file holds the inputs for many sites in binary form.
+
+  Scenario files are written by ScenarioFile::write (see 'ffm compile') from the
+  SiteInputs read from text input files. Reading a scenario file maps it into
+  memory and decodes the sites on demand, so that Location objects can be built
+  without any text parsing. All numbers are stored in native byte order, which
+  is recorded in the header and checked on opening, and doubles are stored
+  exactly so that a compiled site reproduces the results of its text file.
+
+  Layout (version 1):
+    header   magic "FFMSCEN", uint32 version, uint32 byte order mark,
+             uint64 number of sites, uint64 offset of the site index
+    sites    one record per site, see encodeSite in scenario_file.cc
+    index    uint64 offset of each site record
+*/
+class ScenarioFile {
+public:
+
+  static constexpr uint32_t VERSION = 1;
+
+  //constructors
+
+  ScenarioFile(const std::string& path);
+  ~ScenarioFile();
+
+  ScenarioFile(const ScenarioFile&) = delete;
+  ScenarioFile& operator=(const ScenarioFile&) = delete;
+
+  //accessors
+
+  size_t numSites() const;
+  std::string siteName(const size_t& i) const;
+  SiteInputs siteInputs(const size_t& i) const;
+  Location location(const size_t& i) const;
+
+  //other methods
+
+  static bool isScenarioFile(const std::string& path);
+
+  static void write(const std::string& path,
+		    const std::vector<std::string>& siteNames,
+		    const std::vector<SiteInputs>& sites);
+
+private:
+
+  std::string path_;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<uint64_t> offsets_;
+  std::string buffer_; // used instead of a mapping where mmap is unavailable
+
+  void unmap();
+  void siteBounds(const size_t& i, const char*& begin, const char*& end) const;
+};
+
+#include "scenario_file_inline.h"
+
+#endif //SCENARIO_FILE_H
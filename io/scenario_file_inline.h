@@ -0,0 +1,15 @@
+#ifndef SCENARIO_FILE_INLINE_H
+#define SCENARIO_FILE_INLINE_H
+
+/*!\brief Number of sites
+  \return The number of sites held in the scenario file
+*/
+inline size_t ScenarioFile::numSites() const {return offsets_.size();}
+
+/*!\brief Location for a site
+  \param i The index of the site, 0 <= i < numSites()
+  \return The Location constructed from the inputs of site i
+*/
+inline Location ScenarioFile::location(const size_t& i) const {return buildLocation(siteInputs(i));}
+
+#endif //SCENARIO_FILE_INLINE_H
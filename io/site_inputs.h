@@ -0,0 +1,90 @@
+#ifndef SITE_INPUTS_H
+#define SITE_INPUTS_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include "species.h"
+#include "stratum.h"
+#include "forest.h"
+#include "results.h"
+
+/*!\brief The model inputs for a single site, as read from an input file.
+
+  A SiteInputs object holds the values from which a Location is constructed,
+  after any unit conversions and Monte Carlo sampling have been applied but
+  before any Species, Stratum or Forest objects have been built. It is the
+  intermediate form shared by the text input parser and the binary scenario
+  file, so that both construct their Location objects in the same way (see
+  buildLocation in ffm_io).
+*/
+struct SiteInputs {
+
+  /*!\brief Inputs for a single species, see the hexagonal crown Species constructor*/
+  struct SpeciesInputs {
+    std::string name;
+    double composition = 0;
+    double hc = -99, he = -99, ht = -99, hp = -99, w = -99;
+    double liveLeafMoisture = -99;
+    double propDead = -99;
+    double silFreeAshCont = -99;
+    double ignitTemp = -99;
+    Species::LeafFormType leafForm = Species::ROUND_LEAF;
+    double leafThick = -99, leafWidth = -99, leafLength = -99, leafSep = -99;
+    double stemOrder = -99, clumpDiam = -99, clumpSep = -99;
+
+    bool operator==(const SpeciesInputs&) const;
+  };
+
+  /*!\brief Inputs for a single stratum, see the Stratum constructor*/
+  struct StratumInputs {
+    Stratum::LevelType level = Stratum::UNKNOWN_LEVEL;
+    double plantSep = -99;
+    bool include = true;
+    std::vector<SpeciesInputs> species;
+
+    bool operator==(const StratumInputs&) const;
+  };
+
+  Results::OutputLevelType outputLevel = Results::COMPREHENSIVE;
+
+  //surface, with slope in radians and fuel load in kg/m^2
+  double slope = -99;
+  double deadFuelMoistCont = -99;
+  double fuelLoad = -99;
+  double meanFuelDiameter = -99;
+  double meanFinenessLeaves = -99;
+
+  //weather
+  double airTemp = -99;
+
+  //other inputs, with wind speed in m/s
+  double incidentWindSpeed = -99;
+  double firelineLength = -99;
+
+  std::vector<StratumInputs> strata;
+  std::vector<Forest::StrataOverlap> strataOverlaps;
+
+  bool operator==(const SiteInputs&) const;
+};
+
+/*!\brief Replacement values for some of the inputs of a site.
+
+  Values are in the units of the input file, that is wind speed in km/h, slope in
+  degrees and fuel load in tonnes per hectare. A value that is not a number (NaN)
+  leaves the corresponding input unchanged.
+*/
+struct SiteOverrides {
+  double incidentWindSpeed = NAN;
+  double airTemp = NAN;
+  double deadFuelMoistCont = NAN;
+  double slope = NAN;
+  double firelineLength = NAN;
+  double fuelLoad = NAN;
+
+  void apply(SiteInputs& inputs) const;
+};
+
+#include "site_inputs_inline.h"
+
+#endif //SITE_INPUTS_H
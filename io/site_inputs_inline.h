@@ -0,0 +1,62 @@
+#ifndef SITE_INPUTS_INLINE_H
+#define SITE_INPUTS_INLINE_H
+
+/*!\brief Equality of species inputs
+  \return True if every input is identical, no tolerance is applied
+*/
+inline bool SiteInputs::SpeciesInputs::operator==(const SpeciesInputs& other) const {
+  return name == other.name &&
+    composition == other.composition &&
+    hc == other.hc && he == other.he && ht == other.ht && hp == other.hp && w == other.w &&
+    liveLeafMoisture == other.liveLeafMoisture &&
+    propDead == other.propDead &&
+    silFreeAshCont == other.silFreeAshCont &&
+    ignitTemp == other.ignitTemp &&
+    leafForm == other.leafForm &&
+    leafThick == other.leafThick && leafWidth == other.leafWidth &&
+    leafLength == other.leafLength && leafSep == other.leafSep &&
+    stemOrder == other.stemOrder && clumpDiam == other.clumpDiam && clumpSep == other.clumpSep;
+}
+
+/*!\brief Equality of stratum inputs
+  \return True if every input, including those of the species, is identical
+*/
+inline bool SiteInputs::StratumInputs::operator==(const StratumInputs& other) const {
+  return level == other.level &&
+    plantSep == other.plantSep &&
+    include == other.include &&
+    species == other.species;
+}
+
+/*!\brief Equality of site inputs
+  \return True if every input is identical, no tolerance is applied
+*/
+inline bool SiteInputs::operator==(const SiteInputs& other) const {
+  return outputLevel == other.outputLevel &&
+    slope == other.slope &&
+    deadFuelMoistCont == other.deadFuelMoistCont &&
+    fuelLoad == other.fuelLoad &&
+    meanFuelDiameter == other.meanFuelDiameter &&
+    meanFinenessLeaves == other.meanFinenessLeaves &&
+    airTemp == other.airTemp &&
+    incidentWindSpeed == other.incidentWindSpeed &&
+    firelineLength == other.firelineLength &&
+    strata == other.strata &&
+    strataOverlaps == other.strataOverlaps;
+}
+
+/*!\brief Applies overrides to site inputs
+  \param inputs The inputs to be modified
+
+  The same unit conversions are made as when the input file is parsed.
+*/
+inline void SiteOverrides::apply(SiteInputs& inputs) const {
+  if (!std::isnan(incidentWindSpeed)) inputs.incidentWindSpeed = incidentWindSpeed/3.6;
+  if (!std::isnan(airTemp)) inputs.airTemp = airTemp;
+  if (!std::isnan(deadFuelMoistCont)) inputs.deadFuelMoistCont = deadFuelMoistCont;
+  if (!std::isnan(slope)) inputs.slope = slope*PI/180.0;
+  if (!std::isnan(firelineLength)) inputs.firelineLength = firelineLength;
+  if (!std::isnan(fuelLoad)) inputs.fuelLoad = fuelLoad*0.1;
+}
+
+#endif //SITE_INPUTS_INLINE_H
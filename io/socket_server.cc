@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "socket_server.h"
+#include "ffm_io.h"
+#include "ffm_util.h"
+#include "result_emitter.h"
+
+/*!\brief One client connection, closed when the last request from it has been answered*/
+struct SocketServer::Connection {
+  int fd;
+  std::mutex writeMutex;
+  std::string buffer;
+  size_t pos = 0;
+
+  explicit Connection(const int& fd) : fd(fd) {}
+  ~Connection() {close(fd);}
+
+  /*!\brief Reads more of the stream into the buffer, false at end of stream or on error*/
+  bool fill() {
+    if (pos > 0) {
+      buffer.erase(0, pos);
+      pos = 0;
+    }
+    char chunk[1 << 16];
+    ssize_t n;
+    do n = recv(fd, chunk, sizeof(chunk), 0); while (n < 0 && errno == EINTR);
+    if (n <= 0) return false;
+    buffer.append(chunk, n);
+    return true;
+  }
+
+  /*!\brief Reads a line, without its line break, false at end of stream*/
+  bool readLine(std::string& line) {
+    size_t end;
+    while ((end = buffer.find('\n', pos)) == std::string::npos)
+      if (!fill()) {
+	if (pos == buffer.size()) return false;
+	line.assign(buffer, pos, std::string::npos);
+	pos = buffer.size();
+	return true;
+      }
+    line.assign(buffer, pos, end - pos);
+    pos = end + 1;
+    return true;
+  }
+
+  /*!\brief Reads exactly n bytes, false if the stream ends first*/
+  bool readBytes(const size_t& n, std::string& text) {
+    while (buffer.size() - pos < n)
+      if (!fill()) return false;
+    text.assign(buffer, pos, n);
+    pos += n;
+    return true;
+  }
+
+  /*!\brief Writes all of str, records from different threads are not interleaved*/
+  void write(std::string_view str) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    while (!str.empty()) {
+      ssize_t n = send(fd, str.data(), str.size(), MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return; //the client has gone, nothing more can be done
+      str.remove_prefix(n);
+    }
+  }
+};
+
+/*!\brief Constructor, listens on path and starts the workers
+  \param path The socket file, which is replaced if it exists
+  \param numWorkers The number of worker threads, at least one is used
+  \param queueCapacity The maximum number of requests waiting for a worker, at least one
+
+  Throws InputError if the socket cannot be created, so that a host process is not ended.
+*/
+SocketServer::SocketServer(const std::string& path, const size_t& numWorkers,
+			   const size_t& queueCapacity)
+  : path_(path), capacity_(std::max<size_t>(queueCapacity, 1)), latencies_(LATENCY_WINDOW) {
+
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path))
+    throw InputError("Problem with socket - path too long (" + path + ")");
+  strcpy(addr.sun_path, path.c_str());
+
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path.c_str());
+
+  listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd_ < 0 ||
+      bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(listenFd_, SOMAXCONN) < 0) {
+    std::string message = "Problem with socket - " + std::string(strerror(errno)) + " (" + path + ")";
+    if (listenFd_ >= 0) close(listenFd_);
+    throw InputError(message);
+  }
+
+  for (size_t i = 0; i < std::max<size_t>(numWorkers, 1); ++i)
+    workers_.emplace_back(&SocketServer::work, this);
+}
+
+/*!\brief Destructor, stops listening and shuts down the connections
+
+  Readers see the end of their streams, or are woken if waiting for room in the queue, 
+  and no record can be delivered any more, so the workers stop after their current 
+  request and the queued requests are dropped. Every thread is joined before the 
+  members go away.
+*/
+SocketServer::~SocketServer() {
+  close(listenFd_);
+  unlink(path_.c_str());
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    stopping_ = true;
+    for (Reader& reader : readers_)
+      if (std::shared_ptr<Connection> connection = reader.connection.lock())
+	shutdown(connection->fd, SHUT_RDWR);
+  }
+  notFull_.notify_all();
+  notEmpty_.notify_all();
+  joinReaders(true);
+  for (std::thread& t : workers_) t.join();
+}
+
+/*!\brief Accepts connections until the listening socket fails*/
+void SocketServer::run() {
+  while (true) {
+    int fd = accept(listenFd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      std::cout << "Problem with socket - " << strerror(errno) << std::endl;
+      return;
+    }
+    joinReaders(false);
+    std::shared_ptr<Connection> connection = std::make_shared<Connection>(fd);
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    Reader& reader = readers_.emplace_back();
+    reader.connection = connection;
+    reader.thread = std::thread([this, &reader, connection]() mutable {
+	serveConnection(std::move(connection));
+	std::lock_guard<std::mutex> lock(queueMutex_);
+	reader.done = true;
+      });
+  }
+}
+
+/*!\brief Joins the connection reading threads
+  \param all If false only the threads that are done are joined
+*/
+void SocketServer::joinReaders(const bool& all) {
+  std::list<Reader> joined;
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    for (auto it = readers_.begin(); it != readers_.end(); )
+      if (all || it->done)
+	joined.splice(joined.end(), readers_, it++);
+      else
+	++it;
+  }
+  for (Reader& reader : joined) reader.thread.join();
+}
+
+/*!\brief Connects to a server
+  \param path The socket file
+  \return A connected socket, or -1 on failure
+*/
+int SocketServer::connect(const std::string& path) {
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) return -1;
+  strcpy(addr.sun_path, path.c_str());
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/*!\brief Reads the requests of one connection and queues them for the workers*/
+void SocketServer::serveConnection(std::shared_ptr<Connection> connection) {
+  std::string line;
+  int row = 0;
+
+  while (connection->readLine(line)) {
+    std::string_view trimmed = ffm_util::trimView(line, " \t\r");
+    if (trimmed.empty()) continue;
+
+    if (trimmed == "stats") {
+      connection->write(stats());
+      continue;
+    }
+
+    Request request;
+    request.connection = connection;
+    request.row = ++row;
+    request.received = std::chrono::steady_clock::now();
+
+    if (trimmed.find_first_not_of("0123456789") == std::string_view::npos) {
+      size_t length = 0;
+      auto res = std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), length);
+      if (res.ec != std::errc() || length > MAX_DOCUMENT_LENGTH) {
+	std::ostringstream out;
+	ResultEmitter(out, ResultEmitter::NDJSON).emitError("Invalid document length", "socket", row);
+	connection->write(out.str());
+	break;
+      }
+      if (!connection->readBytes(length, request.text)) {
+	std::ostringstream out;
+	ResultEmitter(out, ResultEmitter::NDJSON).emitError("Incomplete document", "socket", row);
+	connection->write(out.str());
+	break;
+      }
+    }
+    else {
+      request.text.assign(trimmed);
+      std::replace(request.text.begin(), request.text.end(), ';', '\n');
+    }
+
+    //wait for room in the queue, this is what slows a client down when the pool is busy
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    notFull_.wait(lock, [this]{return queue_.size() < capacity_ || stopping_;});
+    if (stopping_) break;
+    queue_.push_back(std::move(request));
+    lock.unlock();
+    notEmpty_.notify_one();
+  }
+}
+
+/*!\brief Worker thread, computes queued requests until the server is destroyed*/
+void SocketServer::work() {
+  Results res;
+  std::string error;
+
+  while (true) {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    notEmpty_.wait(lock, [this]{return !queue_.empty() || stopping_;});
+    if (stopping_) return;
+    Request request = std::move(queue_.front());
+    queue_.pop_front();
+    ++busy_;
+    lock.unlock();
+    notFull_.notify_one();
+
+    bool okay = scenarioResults(request.text, res, error);
+    std::ostringstream out;
+    {
+      ResultEmitter emitter(out, ResultEmitter::NDJSON);
+      if (okay)
+	emitter.emit(res, "socket", request.row);
+      else
+	emitter.emitError(error, "socket", request.row);
+    }
+    request.connection->write(out.str());
+
+    std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - request.received;
+    record(latency.count(), !okay);
+
+    lock.lock();
+    --busy_;
+  }
+}
+
+/*!\brief Records the latency of a completed request*/
+void SocketServer::record(const double& latency, const bool& failed) {
+  std::lock_guard<std::mutex> lock(statsMutex_);
+  latencies_[nextLatency_++ % LATENCY_WINDOW] = latency;
+  ++completed_;
+  if (failed) ++failed_;
+}
+
+/*!\brief The current state of the server
+  \return A JSON object on a single line, see the class description
+*/
+std::string SocketServer::stats() const {
+  size_t depth, busy, capacity;
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    depth = queue_.size();
+    busy = busy_;
+    capacity = capacity_;
+  }
+
+  std::vector<double> recent;
+  unsigned long completed, failed;
+  {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    recent.assign(latencies_.begin(), latencies_.begin() + std::min(nextLatency_, LATENCY_WINDOW));
+    completed = completed_;
+    failed = failed_;
+  }
+  std::sort(recent.begin(), recent.end());
+  auto percentile = [&recent](const double& p) {
+    return recent.empty() ? 0.0 : recent[std::min(recent.size() - 1, size_t(p*recent.size()))];
+  };
+
+  char buff[512];
+  snprintf(buff, sizeof(buff),
+	   "{\"queue_depth\":%zu,\"queue_capacity\":%zu,\"workers\":%zu,\"busy\":%zu,"
+	   "\"completed\":%lu,\"failed\":%lu,\"latency_ms\":{\"count\":%zu,"
+	   "\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}}\n",
+	   depth, capacity, workers_.size(), busy, completed, failed, recent.size(),
+	   percentile(0.5), percentile(0.9), percentile(0.99),
+	   recent.empty() ? 0.0 : recent.back());
+  return buff;
+}
@@ -0,0 +1,100 @@
+#ifndef SOCKET_SERVER_H
+#define SOCKET_SERVER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*!\brief Serves scenario requests on a Unix domain socket.
+
+  Requests use the framing of the --serve-stdio worker mode: a line holding a byte
+  count followed by that many bytes of input file text, or a single line of input
+  file text with ';' in place of each line break. Each connection is read by its own
+  thread, which queues the requests for a shared pool of worker threads. The queue is
+  bounded, so when it is full the reading threads wait, the clients' writes back up
+  and the clients are slowed to the rate of the pool.
+
+  Each request gets one NDJSON record, as written by ResultEmitter, with the request
+  number on its connection (from 1) as row. Records are written as requests
+  complete, which with more than one worker need not be the order in which they were
+  sent.
+
+  A byte count above MAX_DOCUMENT_LENGTH, like a document that ends early, gets an
+  error record and the connection is closed.
+
+  A line holding only "stats" is answered at once, ahead of any queued requests, with
+  a single JSON object giving the queue depth and capacity, the number of workers
+  and of requests in progress, counts of completed and failed requests, and latency
+  percentiles in milliseconds over the most recent requests. Latency runs from the
+  time a request is read to the time its record is written, so it includes time
+  spent in the queue.
+*/
+class SocketServer {
+public:
+
+  //constructors
+
+  SocketServer(const std::string& path, const size_t& numWorkers, const size_t& queueCapacity);
+  ~SocketServer();
+
+  SocketServer(const SocketServer&) = delete;
+  SocketServer& operator=(const SocketServer&) = delete;
+
+  //other methods
+
+  void run();
+  std::string stats() const;
+
+  static int connect(const std::string& path);
+
+private:
+
+  struct Connection;
+
+  /*!\brief The thread reading a connection, joined once done or by the destructor*/
+  struct Reader {
+    std::thread thread;
+    std::weak_ptr<Connection> connection;
+    bool done = false;
+  };
+
+  struct Request {
+    std::shared_ptr<Connection> connection;
+    int row;
+    std::string text;
+    std::chrono::steady_clock::time_point received;
+  };
+
+  //number of recent latencies from which percentiles are found
+  static constexpr size_t LATENCY_WINDOW = 4096;
+
+  std::string path_;
+  int listenFd_ = -1;
+  size_t capacity_;
+  std::vector<std::thread> workers_;
+
+  mutable std::mutex queueMutex_;
+  std::condition_variable notEmpty_, notFull_;
+  std::deque<Request> queue_;
+  size_t busy_ = 0;
+  bool stopping_ = false;
+  std::list<Reader> readers_;
+
+  mutable std::mutex statsMutex_;
+  std::vector<double> latencies_;
+  size_t nextLatency_ = 0;
+  unsigned long completed_ = 0, failed_ = 0;
+
+  void serveConnection(std::shared_ptr<Connection> connection);
+  void joinReaders(const bool& all);
+  void work();
+  void record(const double& latency, const bool& failed);
+};
+
+#endif //SOCKET_SERVER_H
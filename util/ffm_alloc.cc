@@ -0,0 +1,136 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+
+#include "ffm_alloc.h"
+
+namespace {
+
+  //the counts of each thread, constant initialised so that they may be used by 
+  //operator new before main, and zero unless tracking
+  thread_local ffm_alloc::Counts counts;
+
+  struct PhaseRecord {
+    unsigned long calls = 0;
+    unsigned long long allocations = 0;
+    unsigned long long bytesAllocated = 0;
+    long long bytesRetained = 0;
+    long long peakBytes = 0;
+  };
+
+  std::mutex& phasesMutex() {
+    static std::mutex m;
+    return m;
+  }
+
+  std::map<std::string, PhaseRecord>& phases() {
+    static std::map<std::string, PhaseRecord> p;
+    return p;
+  }
+
+}
+
+#ifdef FFM_ALLOC_TRACKING
+
+//each block is preceded by a header holding its size, which keeps the alignment of malloc
+namespace {
+  const size_t HEADER = alignof(std::max_align_t);
+
+  //the live bytes and peak live bytes of each thread
+  thread_local long long live = 0;
+  thread_local long long peak = 0;
+}
+
+void* operator new(size_t size) {
+  void* p = malloc(size + HEADER);
+  if (!p) throw std::bad_alloc();
+  *static_cast<size_t*>(p) = size;
+  ++counts.allocations;
+  counts.bytesAllocated += size;
+  live += size;
+  if (live > peak) peak = live;
+  return static_cast<char*>(p) + HEADER;
+}
+
+void operator delete(void* p) noexcept {
+  if (!p) return;
+  char* block = static_cast<char*>(p) - HEADER;
+  size_t size = *reinterpret_cast<size_t*>(block);
+  ++counts.frees;
+  counts.bytesFreed += size;
+  live -= size;
+  free(block);
+}
+
+void* operator new[](size_t size) {return operator new(size);}
+void operator delete[](void* p) noexcept {operator delete(p);}
+void operator delete(void* p, size_t) noexcept {operator delete(p);}
+void operator delete[](void* p, size_t) noexcept {operator delete(p);}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return operator new(size);
+  }
+  catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+void* operator new[](size_t size, const std::nothrow_t& nt) noexcept {return operator new(size, nt);}
+void operator delete(void* p, const std::nothrow_t&) noexcept {operator delete(p);}
+void operator delete[](void* p, const std::nothrow_t&) noexcept {operator delete(p);}
+
+/*!\brief Starts recording the allocations of the calling thread
+  \param name A string literal naming the phase
+*/
+ffm_alloc::Phase::Phase(const char* name) : name_(name), start_(counts), startLive_(live) {
+  peak = live;
+}
+
+ffm_alloc::Phase::~Phase() {end();}
+
+/*!\brief Ends the phase before its destruction, later calls have no effect*/
+void ffm_alloc::Phase::end() {
+  if (!open_) return;
+  open_ = false;
+  Counts now = counts;
+  long long phasePeak = peak - startLive_;
+  std::lock_guard<std::mutex> lock(phasesMutex());
+  PhaseRecord& rec = phases()[name_];
+  ++rec.calls;
+  rec.allocations += now.allocations - start_.allocations;
+  rec.bytesAllocated += now.bytesAllocated - start_.bytesAllocated;
+  rec.bytesRetained += static_cast<long long>(now.bytesAllocated - start_.bytesAllocated) -
+    static_cast<long long>(now.bytesFreed - start_.bytesFreed);
+  if (phasePeak > rec.peakBytes) rec.peakBytes = phasePeak;
+}
+
+#endif //FFM_ALLOC_TRACKING
+
+/*!\brief Allocation counts of the calling thread
+  \return The counts since the thread started, zero unless built with FFM_ALLOC_TRACKING
+*/
+ffm_alloc::Counts ffm_alloc::threadCounts() {return counts;}
+
+/*!\brief Printing of the phases
+  \return A table with a row for each phase name, giving the number of times the phase
+  ran and, per run, the mean number of allocations, kB allocated and kB still held at
+  its end, with the largest peak of live kB above the start of any run
+*/
+std::string ffm_alloc::report() {
+  std::lock_guard<std::mutex> lock(phasesMutex());
+  char buff[200];
+  snprintf(buff, sizeof(buff), "%-28s %8s %12s %14s %14s %12s\n", "phase", "runs", "allocs/run",
+	   "kB alloc/run", "kB held/run", "peak kB");
+  std::string str = buff;
+  for (const auto& p : phases()) {
+    const PhaseRecord& rec = p.second;
+    snprintf(buff, sizeof(buff), "%-28s %8lu %12.1f %14.2f %14.2f %12.2f\n", p.first.c_str(), rec.calls,
+	     double(rec.allocations)/rec.calls, rec.bytesAllocated/1024.0/rec.calls,
+	     rec.bytesRetained/1024.0/rec.calls, rec.peakBytes/1024.0);
+    str += buff;
+  }
+  return str;
+}
@@ -0,0 +1,70 @@
+#ifndef FFM_ALLOC_H
+#define FFM_ALLOC_H
+
+#include <string>
+
+/*!\brief Allocation tracking
+
+  In the allocation tracking build (make ALLOC_TRACKING=1, which defines
+  FFM_ALLOC_TRACKING) the global operator new and delete are replaced by versions that
+  count the allocations, frees and bytes of each thread. Phases of the computation,
+  such as parsing, each ignition run and the assembly of the results, are marked with
+  Phase objects, which record what their thread allocated between construction and
+  end() or destruction. report() sums these by phase name, giving the memory used by
+  one run of each phase from which the needs of many concurrent workers can be sized.
+
+  In other builds the operators are left alone and a Phase does nothing.
+*/
+namespace ffm_alloc {
+
+#ifdef FFM_ALLOC_TRACKING
+  constexpr bool ENABLED = true;
+#else
+  constexpr bool ENABLED = false;
+#endif
+
+  struct Counts {
+    unsigned long allocations = 0;
+    unsigned long frees = 0;
+    unsigned long long bytesAllocated = 0;
+    unsigned long long bytesFreed = 0;
+  };
+
+  // counts of the calling thread since it started, zero unless tracking
+  Counts threadCounts();
+
+  // table of the allocations of each phase recorded so far
+  std::string report();
+
+  /*!\brief A phase of the computation whose allocations are recorded
+
+    Phases on a thread should not be nested, since the peak of a phase is measured
+    from the start of the most recent one.
+  */
+#ifdef FFM_ALLOC_TRACKING
+  class Phase {
+  public:
+    explicit Phase(const char* name);
+    ~Phase();
+
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+    void end();
+
+  private:
+    const char* name_;
+    bool open_ = true;
+    Counts start_;
+    long long startLive_;
+  };
+#else
+  class Phase {
+  public:
+    explicit Phase(const char*) {}
+    void end() {}
+  };
+#endif
+}
+
+#endif //FFM_ALLOC_H
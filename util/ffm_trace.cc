@@ -0,0 +1,144 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "ffm_trace.h"
+
+namespace {
+
+  using Clock = std::chrono::steady_clock;
+
+  struct Event {
+    const char* name;
+    std::string detail;
+    int index;
+    int tid;
+    double ts;   //microseconds from enable()
+    double dur;  //microseconds
+  };
+
+  std::atomic<bool> tracing(false);
+  Clock::time_point origin;
+  std::mutex eventsMutex;
+  std::vector<Event> events;
+
+  //threads are numbered in the order in which they first end a span
+  std::atomic<int> nextThreadId(0);
+
+  int threadId() {
+    thread_local int id = nextThreadId++;
+    return id;
+  }
+
+  double micros(const Clock::duration& d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+  }
+
+  std::string escaped(const std::string& str) {
+    std::string out;
+    for (char c : str) {
+      if (c == '"' || c == '\\') {
+	out += '\\';
+	out += c;
+      }
+      else if (static_cast<unsigned char>(c) < 0x20) {
+	char buff[8];
+	snprintf(buff, sizeof(buff), "\\u%04x", c);
+	out += buff;
+      }
+      else
+	out += c;
+    }
+    return out;
+  }
+
+}
+
+/*!\brief Starts collecting spans
+
+  Spans collected earlier are discarded and the times of those that follow are measured
+  from now. Spans that are open when tracing is enabled are not recorded.
+*/
+void ffm_trace::enable() {
+  std::lock_guard<std::mutex> lock(eventsMutex);
+  events.clear();
+  origin = Clock::now();
+  tracing = true;
+}
+
+/*!\brief Whether spans are being collected*/
+bool ffm_trace::enabled() {return tracing;}
+
+/*!\brief Writes the collected spans as a Chrome trace event file
+  \param path
+  \return False if the file could not be written
+
+  Each span is a complete event ("ph":"X") of process 1 on the track of its thread,
+  with times in microseconds. The detail and index of a span, when given, are its args.
+*/
+bool ffm_trace::write(const std::string& path) {
+  std::lock_guard<std::mutex> lock(eventsMutex);
+  std::ofstream out(path);
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  char buff[128];
+  std::set<int> threads;
+  bool first = true;
+  for (const Event& e : events) {
+    snprintf(buff, sizeof(buff), "\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f", e.tid, e.ts, e.dur);
+    out << (first ? "\n" : ",\n") << "{\"name\":\"" << e.name << "\",\"cat\":\"ffm\"," << buff;
+    if (!e.detail.empty() || e.index >= 0) {
+      out << ",\"args\":{";
+      if (!e.detail.empty()) out << "\"detail\":\"" << escaped(e.detail) << "\"";
+      if (e.index >= 0) out << (e.detail.empty() ? "" : ",") << "\"index\":" << e.index;
+      out << "}";
+    }
+    out << "}";
+    threads.insert(e.tid);
+    first = false;
+  }
+  for (int tid : threads) {
+    out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+	<< ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+    first = false;
+  }
+  out << "\n]}" << std::endl;
+  return static_cast<bool>(out);
+}
+
+/*!\brief Opens a span
+  \param name A string literal naming the phase
+*/
+ffm_trace::Span::Span(const char* name) : name_(name) {
+  if (!tracing) return;
+  open_ = true;
+  start_ = Clock::now();
+}
+
+/*!\brief Opens a span
+  \param name A string literal naming the phase
+  \param detail Distinguishes spans of the same name, such as a stratum or species
+  \param index Distinguishes spans of the same name and detail, ignored if negative
+*/
+ffm_trace::Span::Span(const char* name, std::string_view detail, const int& index) : name_(name) {
+  if (!tracing) return;
+  detail_.assign(detail.data(), detail.size());
+  index_ = index;
+  open_ = true;
+  start_ = Clock::now();
+}
+
+ffm_trace::Span::~Span() {end();}
+
+/*!\brief Ends the span before its destruction, later calls have no effect*/
+void ffm_trace::Span::end() {
+  if (!open_) return;
+  open_ = false;
+  Clock::time_point now = Clock::now();
+  int tid = threadId();
+  std::lock_guard<std::mutex> lock(eventsMutex);
+  if (!tracing || start_ < origin) return;
+  events.push_back(Event{name_, detail_, index_, tid, micros(start_ - origin), micros(now - start_)});
+}
@@ -0,0 +1,52 @@
+#ifndef FFM_TRACE_H
+#define FFM_TRACE_H
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+/*!\brief Timeline tracing of the model computation
+
+  Spans mark phases of the computation, such as Location::results() and the ignition
+  runs, strata and species within it. When tracing is enabled each span records its
+  start time, duration and thread when it ends, and the spans can be written as a
+  Chrome trace event file, to be opened in chrome://tracing or Perfetto. Spans on
+  different threads appear on separate tracks, so load imbalance between workers and
+  the longest chains of work can be seen.
+
+  Tracing is off by default, when constructing and destroying a span only tests a flag.
+  The detail of a span is copied only while tracing, so callers should pass it without
+  building a string.
+*/
+namespace ffm_trace {
+
+  // starts collecting spans, discarding any collected earlier. Times are measured from here
+  void enable();
+
+  bool enabled();
+
+  // writes the collected spans as Chrome trace event JSON, returning false on failure
+  bool write(const std::string& path);
+
+  /*!\brief A traced phase, from construction until end() or destruction*/
+  class Span {
+  public:
+    explicit Span(const char* name);
+    Span(const char* name, std::string_view detail, const int& index = -1);
+    ~Span();
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    void end();
+
+  private:
+    const char* name_;
+    std::string detail_;
+    int index_ = -1;
+    bool open_ = false;
+    std::chrono::steady_clock::time_point start_;
+  };
+}
+
+#endif //FFM_TRACE_H
@@ -1,7 +1,13 @@
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <random>
 
 #include "ffm_util.h"
@@ -33,7 +39,25 @@ static __inline__ unsigned long long rdtsc(void)
 
 namespace ffm_util {
   
-  std::mt19937 GENERATOR( rdtsc() );
+  //one generator per thread, so that Monte Carlo sampling on one thread never 
+  //touches the state of another
+  thread_local std::mt19937 GENERATOR( rdtsc() );
+
+  /*!\brief Reseeds the generator of the calling thread
+    \param seed
+    \param stream For example the number of a Monte Carlo iteration
+
+    The key is mixed with the splitmix64 finaliser so that neighbouring streams give
+    unrelated sequences.
+  */
+  void seedRandom(const unsigned long long& seed, const unsigned long long& stream) {
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL*(stream + 1);
+    z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    std::seed_seq seq{static_cast<uint32_t>(z), static_cast<uint32_t>(z >> 32)};
+    GENERATOR.seed(seq);
+  }
 
   /*!\brief Trims leading and trailing white space
     \param str
@@ -86,6 +110,68 @@ namespace ffm_util {
     return ret;
   }
 
+  /*!\brief Trims leading and trailing white space without copying
+    \param str
+    \param whitespace = " \t"
+    \return A view into str with all leading and trailing white space removed
+
+    Note that the second parameter is optional and defaults to " \t"
+  */
+  std::string_view trimView(std::string_view str,
+			    std::string_view whitespace) {
+    const auto strBegin = str.find_first_not_of(whitespace);
+    if (strBegin == std::string_view::npos) return std::string_view(); // no content
+    const auto strEnd = str.find_last_not_of(whitespace);
+    return str.substr(strBegin, strEnd - strBegin + 1);
+  }
+
+  /*!\brief Takes the next element of a separated string
+    \param str The string to be split, advanced past the element taken
+    \param ch The separator
+    \param field Set to the element taken, with leading and trailing white space removed
+    \return False if str has no elements left, true otherwise
+
+    Repeated calls visit the same elements, in the same order, as split(str, ch)
+    but without copying them. Empty elements (adjacent separators) are skipped.
+  */
+  bool nextField(std::string_view& str, const char& ch, std::string_view& field) {
+    while (!str.empty()) {
+      const auto pos = str.find(ch);
+      if (pos == std::string_view::npos) {
+	field = trimView(str);
+	str = std::string_view();
+	return true;
+      }
+      if (pos > 0) {
+	field = trimView(str.substr(0, pos));
+	str.remove_prefix(pos + 1);
+	return true;
+      }
+      str.remove_prefix(1);
+    }
+    return false;
+  }
+
+  /*!\brief Conversion from string to double without validation
+    \param str
+    \return The double represented by the longest numeric prefix of str
+    (after any leading white space), or zero if there is none, as atof does
+  */
+  double toDouble(std::string_view str) {
+    size_t i = 0;
+    while (i < str.size() && isspace(static_cast<unsigned char>(str[i]))) ++i;
+    //from_chars does not accept a leading '+'
+    if (i < str.size() && str[i] == '+') {
+      ++i;
+      if (i < str.size() && str[i] == '-') return 0;
+    }
+    double value = 0;
+    auto res = std::from_chars(str.data() + i, str.data() + str.size(), value);
+    if (res.ec == std::errc::result_out_of_range)
+      return atof(std::string(str).c_str());
+    return res.ec == std::errc() ? value : 0;
+  }
+
   /*!\brief Number of non-zero elements
     \param data
     \return A count of the number of non-zero elements in data
@@ -138,6 +224,44 @@ namespace ffm_util {
     return *i;
   }
 
+  /*!\brief Adds a value, using Welford's update
+    \param x
+  */
+  void RunningStats::add(const double& x) {
+    if (count == 0) min = max = x;
+    min = std::min(min, x);
+    max = std::max(max, x);
+    ++count;
+    double delta = x - mean;
+    mean += delta/count;
+    m2 += delta*(x - mean);
+  }
+
+  /*!\brief Adds the values summarised by other, using the pairwise update of Chan et al.
+    \param other
+  */
+  void RunningStats::merge(const RunningStats& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+      *this = other;
+      return;
+    }
+    long n = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta*other.count/n;
+    m2 += other.m2 + delta*delta*count*other.count/n;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count = n;
+  }
+
+  /*!\brief Sample standard deviation
+    \return Zero if there are fewer than two values
+  */
+  double RunningStats::stdDev() const {
+    return count < 2 ? 0.0 : std::sqrt(m2/(count - 1));
+  }
+
   /*!\brief Maximum value capped by mean + 1 standard deviation
     \param data
     \param ignoreZeros = true
@@ -188,12 +312,13 @@ namespace ffm_util {
     to be the mean and the standard deviation is taken to be zero.
     \return A random value from the specified Gaussian distribution
   */
-  double randomNormal(const std::string& str) {
+  double randomNormal(std::string_view str) {
     //expects str to be comma separated pair representing mean and stdDev
     //if only one value then assumes stdDev is zero
-    std::vector<std::string> strVec = ffm_util::split(str, ',');
-    if (strVec.size() == 1) return atof(strVec.at(0).c_str());
-    return ffm_util::randomNormal(atof(strVec.at(0).c_str()), atof(strVec.at(1).c_str()));
+    std::string_view mean, stdDev;
+    nextField(str, ',', mean);
+    if (!nextField(str, ',', stdDev)) return toDouble(mean);
+    return ffm_util::randomNormal(toDouble(mean), toDouble(stdDev));
   }
 
   /*!\brief Random number from specified uniform distribution
@@ -202,12 +327,13 @@ namespace ffm_util {
     to be the mean and the range is taken to be zero.
     \return A random value from the specified uniform distribution
   */
-  double randomUniform(const std::string& str) {
+  double randomUniform(std::string_view str) {
     //expects str to be comma separated pair representing mean and range
     //if only one value then assumes range is zero
-    std::vector<std::string> strVec = ffm_util::split(str, ',');
-    if (strVec.size() == 1) return atof(strVec.at(0).c_str());
-    return ffm_util::randomUniform(atof(strVec.at(0).c_str()), atof(strVec.at(1).c_str()));
+    std::string_view mean, range;
+    nextField(str, ',', mean);
+    if (!nextField(str, ',', range)) return toDouble(mean);
+    return ffm_util::randomUniform(toDouble(mean), toDouble(range));
   }
 
 }
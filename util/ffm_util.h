@@ -2,6 +2,7 @@
 #define FFM_UTIL_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 /*!\brief Various useful utilities*/
@@ -21,6 +22,17 @@ namespace ffm_util {
   // removes leading and trailing whitespace
   // returns vector of strings
 
+  std::string_view trimView(std::string_view str,
+			    std::string_view whitespace = " \t");
+  // as trim but returns a view into str rather than a copy
+
+  bool nextField(std::string_view& str, const char& ch, std::string_view& field);
+  // takes the next element of str in the sense of split, without copying
+  // advances str past the element, returns false when none remain
+
+  double toDouble(std::string_view str);
+  // converts the leading numeric part of str, as atof does
+
   //statistics utility functions ******************
 
   int nonNullCount(const std::vector<double>& data);
@@ -29,12 +41,31 @@ namespace ffm_util {
   double maxVal(const std::vector<double>& data);
   double cappedMax(const std::vector<double>& data, const bool& ignoreZeros = true);
 
+  // count, mean, sum of squared deviations and range of a stream of values,
+  // which can be merged so that statistics of separate runs may be combined
+  struct RunningStats {
+    long count = 0;
+    double mean = 0;
+    double m2 = 0;
+    double min = 0;
+    double max = 0;
+
+    void add(const double& x);
+    void merge(const RunningStats& other);
+    double stdDev() const;
+  };
+
   //random number generation
+
+  // reseeds the generator of the calling thread from seed and stream, so that the
+  // draws that follow depend only on them and not on any earlier draws
+  void seedRandom(const unsigned long long& seed, const unsigned long long& stream);
+
   double randomNormal(const double& mean, const double& stdDev);
 
   //expects str to be comma separated pair representing mean and stdDev
   //if only one value then assumes stdDev is zero
-  double randomNormal(const std::string& str);
+  double randomNormal(std::string_view str);
 
 
   double randomUniform(const double& mean, const double& range);
@@ -44,7 +75,7 @@ namespace ffm_util {
 
   //expects str to be comma separated pair representing mean and range
   //if only one value then assumes range is zero
-  double randomUniform(const std::string& str);
+  double randomUniform(std::string_view str);
 }
 
 #endif //FFM_UTIL_H